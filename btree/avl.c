@@ -0,0 +1,176 @@
+/*
+ * Samovyvažovací (AVL) binární vyhledávací strom
+ *
+ * Funkce bst_avl_insert a bst_avl_delete mají stejný význam jako bst_insert
+ * a bst_delete včetně uvolňování nahrazených a odstraněných hodnot, po každé
+ * změně ale rotacemi obnoví podmínku AVL: výšky levého a pravého podstromu
+ * každého uzlu se liší nejvýše o jedna. Výška stromu tak zůstává
+ * logaritmická i pro seřazené klíče.
+ *
+ * Výšku podstromu si uzel ukládá v položce height, proto se strom smí měnit
+ * jen těmito funkcemi (bst_insert, bst_delete ani bst_balance výšky
+ * neudržují). Vyhledávání, průchody a bst_dispose fungují beze změny.
+ */
+
+#include "btree.h"
+#include <stdlib.h>
+
+// Returns the height of the subtree, 0 for an empty one
+static int bst_avl_height(bst_node_t *tree) {
+    return tree != NULL ? tree->height : 0;
+}
+
+// Recomputes the height of the node from its children
+static void bst_avl_update(bst_node_t *tree) {
+    int left = bst_avl_height(tree->left);
+    int right = bst_avl_height(tree->right);
+    tree->height = 1 + (left > right ? left : right);
+}
+
+// Rotates the subtree to the right, returns its new root
+static bst_node_t *bst_avl_rotate_right(bst_node_t *tree) {
+    bst_node_t *root = tree->left;
+    tree->left = root->right;
+    root->right = tree;
+    bst_avl_update(tree);
+    bst_avl_update(root);
+    return root;
+}
+
+// Rotates the subtree to the left, returns its new root
+static bst_node_t *bst_avl_rotate_left(bst_node_t *tree) {
+    bst_node_t *root = tree->right;
+    tree->right = root->left;
+    root->left = tree;
+    bst_avl_update(tree);
+    bst_avl_update(root);
+    return root;
+}
+
+/*
+ * Obnoví podmínku AVL v kořeni podstromu, jehož podstromy ji splňují.
+ *
+ * Vrací nový kořen podstromu.
+ */
+static bst_node_t *bst_avl_rebalance(bst_node_t *tree) {
+    bst_avl_update(tree);
+    int balance = bst_avl_height(tree->left) - bst_avl_height(tree->right);
+
+    if (balance > 1) {
+        // Left-right case is turned into the left-left case first
+        if (bst_avl_height(tree->left->left) <
+            bst_avl_height(tree->left->right)) {
+            tree->left = bst_avl_rotate_left(tree->left);
+        }
+        return bst_avl_rotate_right(tree);
+    }
+
+    if (balance < -1) {
+        // Right-left case is turned into the right-right case first
+        if (bst_avl_height(tree->right->right) <
+            bst_avl_height(tree->right->left)) {
+            tree->right = bst_avl_rotate_right(tree->right);
+        }
+        return bst_avl_rotate_left(tree);
+    }
+
+    return tree;
+}
+
+/*
+ * Vložení uzlu do AVL stromu.
+ *
+ * Pokud uzel se zadaným klíčem už ve stromu existuje, uvolní se jeho
+ * původní hodnota a nahradí se novou. Jinak se vloží nový list a strom se
+ * na cestě ke kořeni vyváží.
+ */
+void bst_avl_insert(bst_node_t **tree, char key, bst_node_content_t value) {
+    // If the current tree is NULL, insert new node
+    if (*tree == NULL) {
+        *tree = malloc(sizeof(bst_node_t));
+        if (*tree == NULL) {
+            return;
+        }
+
+        (*tree)->key = key;
+        (*tree)->height = 1;
+        (*tree)->content = value;
+        (*tree)->left = NULL;
+        (*tree)->right = NULL;
+        return;
+    }
+
+    // If key already exists, update its value, the shape does not change
+    if (key == (*tree)->key) {
+        if ((*tree)->content.value != NULL) {
+            free((*tree)->content.value);
+        }
+        (*tree)->content = value;
+        return;
+    }
+
+    if (key < (*tree)->key) {
+        bst_avl_insert(&(*tree)->left, key, value);
+    } else {
+        bst_avl_insert(&(*tree)->right, key, value);
+    }
+    *tree = bst_avl_rebalance(*tree);
+}
+
+/*
+ * Nahradí klíč a hodnotu uzlu target nejpravějším uzlem podstromu tree.
+ *
+ * Nejpravější uzel se odstraní a podstrom se na cestě zpět vyváží.
+ */
+static void bst_avl_replace_by_rightmost(bst_node_t *target,
+                                         bst_node_t **tree) {
+    if ((*tree)->right == NULL) {
+        target->key = (*tree)->key;
+        target->content = (*tree)->content;
+
+        // Free the rightmost node, but preserve its left subtree
+        bst_node_t *toFree = *tree;
+        *tree = (*tree)->left;
+        free(toFree);
+        return;
+    }
+
+    bst_avl_replace_by_rightmost(target, &(*tree)->right);
+    *tree = bst_avl_rebalance(*tree);
+}
+
+/*
+ * Odstranění uzlu z AVL stromu.
+ *
+ * Pokud uzel se zadaným klíčem neexistuje, funkce nic nedělá. Uzel s oběma
+ * podstromy se stejně jako v bst_delete nahradí nejpravějším uzlem levého
+ * podstromu. Hodnota odstraněného uzlu se uvolní.
+ */
+void bst_avl_delete(bst_node_t **tree, char key) {
+    // Check if the pointer to tree is valid
+    if (*tree == NULL) {
+        return;
+    }
+
+    if (key < (*tree)->key) {
+        bst_avl_delete(&(*tree)->left, key);
+    } else if (key > (*tree)->key) {
+        bst_avl_delete(&(*tree)->right, key);
+    } else {
+        if ((*tree)->content.value != NULL) {
+            free((*tree)->content.value);
+            (*tree)->content.value = NULL;
+        }
+
+        // A node with at most one subtree is replaced by that subtree
+        if ((*tree)->left == NULL || (*tree)->right == NULL) {
+            bst_node_t *toFree = *tree;
+            *tree = (*tree)->left != NULL ? (*tree)->left : (*tree)->right;
+            free(toFree);
+            return;
+        }
+
+        bst_avl_replace_by_rightmost(*tree, &(*tree)->left);
+    }
+    *tree = bst_avl_rebalance(*tree);
+}
@@ -0,0 +1,97 @@
+/*
+ * Vyvážení binárního vyhledávacího stromu (algoritmus Day–Stout–Warren)
+ *
+ * Strom se nejdříve rotacemi doprava narovná do "páteře" (seznamu spojeného
+ * pravými ukazateli v pořadí inorder) a páteř se pak opakovanými rotacemi
+ * doleva složí do úplného vyváženého stromu. Obě fáze pracují v čase O(n)
+ * a kromě několika ukazatelů nepotřebují žádnou další paměť, takže funkce
+ * nezávisí na rekurzivní ani iterativní variantě stromu.
+ */
+
+#include "btree.h"
+#include <stddef.h>
+
+/*
+ * Narovná strom pod pravým ukazatelem root do páteře.
+ *
+ * Vrací počet uzlů stromu.
+ */
+static size_t bst_tree_to_vine(bst_node_t *root) {
+    bst_node_t *tail = root;
+    bst_node_t *rest = tail->right;
+    size_t size = 0;
+
+    while (rest != NULL) {
+        if (rest->left == NULL) {
+            // The node is already part of the vine, moves on
+            tail = rest;
+            rest = rest->right;
+            size++;
+        } else {
+            // Rotates the left child up to the vine
+            bst_node_t *child = rest->left;
+            rest->left = child->right;
+            child->right = rest;
+            rest = child;
+            tail->right = child;
+        }
+    }
+    return size;
+}
+
+/*
+ * Provede count rotací doleva podél pravé větve pod uzlem root.
+ */
+static void bst_compress(bst_node_t *root, size_t count) {
+    bst_node_t *scanner = root;
+
+    for (size_t i = 0; i < count; i++) {
+        // Rotates every second node of the vine to the left
+        bst_node_t *child = scanner->right;
+        scanner->right = child->right;
+        scanner = scanner->right;
+        child->right = scanner->left;
+        scanner->left = child;
+    }
+}
+
+/*
+ * Složí páteř pod pravým ukazatelem root do vyváženého stromu.
+ */
+static void bst_vine_to_tree(bst_node_t *root, size_t size) {
+    // Finds the size of the largest complete tree that fits
+    size_t full = 1;
+    while (full <= size + 1) {
+        full *= 2;
+    }
+    full = full / 2 - 1;
+
+    // Moves the extra nodes to the bottom level first
+    bst_compress(root, size - full);
+
+    size = full;
+    while (size > 1) {
+        size /= 2;
+        bst_compress(root, size);
+    }
+}
+
+/*
+ * Vyvážení stromu.
+ *
+ * Přeskupí uzly stromu tak, aby se výšky levého a pravého podstromu každého
+ * uzlu lišily nejvýše o jedna a všechny hladiny kromě poslední byly plné.
+ * Klíče ani hodnoty uzlů se nemění, uzly se nealokují ani neuvolňují.
+ */
+void bst_balance(bst_node_t **tree) {
+    // Check if pointer to tree is valid
+    if (tree == NULL || *tree == NULL) {
+        return;
+    }
+
+    // Uses a pseudo root so that the real root can be rotated as well
+    bst_node_t root = {.left = NULL, .right = *tree};
+    size_t size = bst_tree_to_vine(&root);
+    bst_vine_to_tree(&root, size);
+    *tree = root.right;
+}
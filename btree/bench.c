@@ -0,0 +1,1178 @@
+/*
+ * Výkonnostní testy binárního vyhledávacího stromu:
+ *   - výška a vyhledávání ve stromu z klíčů v degenerovaném (seřazené,
+ *     obrácené, střídavé) a v náhodném pořadí před vyvážením a po něm,
+ *   - vkládání, vyhledávání a mazání v obyčejném a v AVL stromu,
+ *   - průchody se zásobníkem a bez něj na velkých stromech,
+ *   - stromy s uzly z alokátoru po blocích,
+ *   - vyhledávání ve stromu s ukazateli, ve zmrazeném stromu a v B+ stromu,
+ *   - strom s klíči int64_t, tentýž strom porovnávající přes ukazatel na
+ *     funkci a strom s řetězcovými klíči,
+ *   - rozsahové dotazy a filtrování celého průchodu,
+ *   - průchod iterátorem a průchod do bst_items_t,
+ *   - vytvoření stromu ze seřazených klíčů a vkládání,
+ *   - paralelní průchod a zrušení stromu s různým počtem vláken,
+ *   - čtení perzistentního stromu a stromu se zámkem čtenářů a
+ *     zapisujících při současných změnách,
+ *   - současné vyhledávání a změny v několika vláknech ve stromu se zámky
+ *     v uzlech a ve stromu s jedním zámkem,
+ *   - počítání znaků funkcí letter_count a znak po znaku ve stromu.
+ */
+#include "btree.h"
+#include "pool.h"
+#include "frozen.h"
+#include "bplus.h"
+#include "keyed.h"
+#include "iterator.h"
+#include "persist.h"
+#include "concurrent.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Number of distinct keys, the tree takes char keys
+#define BENCH_KEYS 256
+#define BENCH_ROUNDS 2000
+
+// Number of trees built and disposed by the pool benchmark
+#define BENCH_POOL_TREES 20000
+
+// Largest tree of the traversal benchmark
+#define BENCH_LARGE_NODES 1000000
+
+// Number of searches in every large tree
+#define BENCH_SEARCHES 4000000
+
+// Number of keys of the key type benchmark
+#define BENCH_KEYED_KEYS 100000
+
+// Number of queries of the range benchmark and the keys each one returns
+#define BENCH_RANGES 1000
+#define BENCH_RANGE_KEYS 100
+
+// Keys and duration in ms of every run of the concurrent benchmarks
+#define BENCH_CONCURRENT_KEYS 100000
+#define BENCH_CONCURRENT_MS 200
+
+// Most threads of the mixed read and write benchmark
+#define BENCH_CONCURRENT_THREADS 4
+
+// Length of the text for letter_count
+#define BENCH_TEXT_LENGTH (64 * 1024 * 1024)
+
+static unsigned long long bench_state = 0x2545F4914F6CDD1DULL;
+
+// Deterministic xorshift generator so that every run uses the same keys
+static unsigned bench_random(void) {
+    bench_state ^= bench_state << 13;
+    bench_state ^= bench_state >> 7;
+    bench_state ^= bench_state << 17;
+    return (unsigned)(bench_state >> 32);
+}
+
+// Returns monotonic-enough wall clock time in nanoseconds
+static double bench_now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Returns the height of the tree, the walk itself is not measured
+static int bench_height(bst_node_t *tree) {
+    if (tree == NULL) {
+        return 0;
+    }
+    int left = bench_height(tree->left);
+    int right = bench_height(tree->right);
+    return 1 + (left > right ? left : right);
+}
+
+// Fills the keys in ascending order
+static void bench_order_sorted(char keys[], int count) {
+    for (int i = 0; i < count; i++) {
+        keys[i] = (char)(i - 128);
+    }
+}
+
+// Fills the keys in descending order
+static void bench_order_reverse(char keys[], int count) {
+    for (int i = 0; i < count; i++) {
+        keys[i] = (char)(127 - i);
+    }
+}
+
+// Alternates the smallest and the largest remaining key
+static void bench_order_zigzag(char keys[], int count) {
+    for (int i = 0; i < count; i++) {
+        keys[i] = (char)(i % 2 == 0 ? i / 2 - 128 : 127 - i / 2);
+    }
+}
+
+// Shuffles the ascending keys
+static void bench_order_random(char keys[], int count) {
+    bench_order_sorted(keys, count);
+    for (int i = count - 1; i > 0; i--) {
+        int j = (int)(bench_random() % (unsigned)(i + 1));
+        char swap = keys[i];
+        keys[i] = keys[j];
+        keys[j] = swap;
+    }
+}
+
+typedef struct bench_order {
+    const char *name;
+    void (*fill)(char keys[], int count);
+} bench_order_t;
+
+static const bench_order_t bench_orders[] = {
+    {"sorted", bench_order_sorted},
+    {"reverse", bench_order_reverse},
+    {"zigzag", bench_order_zigzag},
+    {"random", bench_order_random},
+};
+
+// Returns the average time of one search for every key of the tree
+static double bench_search(bst_node_t *tree, const char keys[], int count) {
+    bst_node_content_t *content = NULL;
+    int found = 0;
+
+    double start = bench_now();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int i = 0; i < count; i++) {
+            found += bst_search(tree, keys[i], &content);
+        }
+    }
+    double elapsed = bench_now() - start;
+
+    // Keeps the compiler from optimizing the searches away
+    if (found != count * BENCH_ROUNDS) {
+        printf("missing keys: %d\n", count * BENCH_ROUNDS - found);
+    }
+    return elapsed / ((double)count * BENCH_ROUNDS);
+}
+
+// Measures one insertion order before and after balancing
+static void bench_balance(const bench_order_t *order) {
+    char keys[BENCH_KEYS];
+    order->fill(keys, BENCH_KEYS);
+
+    bst_node_t *tree;
+    bst_init(&tree);
+    bst_node_content_t content = {.value = NULL, .type = INTEGER};
+    for (int i = 0; i < BENCH_KEYS; i++) {
+        bst_insert(&tree, keys[i], content);
+    }
+
+    int height = bench_height(tree);
+    double before = bench_search(tree, keys, BENCH_KEYS);
+
+    double start = bench_now();
+    bst_balance(&tree);
+    double balance = bench_now() - start;
+
+    int balanced_height = bench_height(tree);
+    double after = bench_search(tree, keys, BENCH_KEYS);
+
+    printf("%-10s %8d %12.1f %8d %12.1f %12.1f\n", order->name, height,
+           before, balanced_height, after, balance / 1000);
+
+    bst_dispose(&tree);
+}
+
+// Compares plain and AVL insertion, search and deletion in one order
+static void bench_avl(const bench_order_t *order) {
+    char keys[BENCH_KEYS];
+    order->fill(keys, BENCH_KEYS);
+    bst_node_content_t content = {.value = NULL, .type = INTEGER};
+
+    bst_node_t *plain;
+    bst_node_t *avl;
+    bst_init(&plain);
+    bst_init(&avl);
+
+    double start = bench_now();
+    for (int i = 0; i < BENCH_KEYS; i++) {
+        bst_insert(&plain, keys[i], content);
+    }
+    double plain_insert = bench_now() - start;
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_KEYS; i++) {
+        bst_avl_insert(&avl, keys[i], content);
+    }
+    double avl_insert = bench_now() - start;
+
+    int plain_height = bench_height(plain);
+    int avl_height = bench_height(avl);
+    double plain_search = bench_search(plain, keys, BENCH_KEYS);
+    double avl_search = bench_search(avl, keys, BENCH_KEYS);
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_KEYS; i++) {
+        bst_delete(&plain, keys[i]);
+    }
+    double plain_delete = bench_now() - start;
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_KEYS; i++) {
+        bst_avl_delete(&avl, keys[i]);
+    }
+    double avl_delete = bench_now() - start;
+
+    printf("%-10s %6s %12.1f %12.1f %12.1f %8d\n", order->name, "plain",
+           plain_insert / BENCH_KEYS, plain_search, plain_delete / BENCH_KEYS,
+           plain_height);
+    printf("%-10s %6s %12.1f %12.1f %12.1f %8d\n", "", "avl",
+           avl_insert / BENCH_KEYS, avl_search, avl_delete / BENCH_KEYS,
+           avl_height);
+
+    bst_dispose(&plain);
+    bst_dispose(&avl);
+}
+
+// Inserts a new node with an integer key and no value into the tree
+static void bench_insert(bst_node_t **tree, int key) {
+    bst_node_t *node = malloc(sizeof(bst_node_t));
+    node->key = key;
+    node->height = 1;
+    node->content.value = NULL;
+    node->content.type = INTEGER;
+    node->left = NULL;
+    node->right = NULL;
+
+    // Walks down to the free child slot of the new key
+    while (*tree != NULL) {
+        tree = key < (*tree)->key ? &(*tree)->left : &(*tree)->right;
+    }
+    *tree = node;
+}
+
+/*
+ * Vytvoří náhodný strom s count uzly a celočíselnými klíči.
+ *
+ * bst_insert přijímá jen klíče typu char, proto se uzly vkládají přímo;
+ * průchody klíče neporovnávají.
+ */
+static bst_node_t *bench_large_tree(int count) {
+    bst_node_t *tree = NULL;
+    for (int i = 0; i < count; i++) {
+        bench_insert(&tree, (int)(bench_random() >> 1));
+    }
+    return tree;
+}
+
+// Returns the time of one traversal per node
+static double bench_traversal(bst_node_t *tree, int count,
+                              void (*traversal)(bst_node_t *, bst_items_t *)) {
+    bst_items_t items = {.nodes = NULL, .capacity = 0, .size = 0};
+
+    // Sizes the items up front so that only the traversal is measured
+    traversal(tree, &items);
+    items.size = 0;
+
+    double start = bench_now();
+    traversal(tree, &items);
+    double elapsed = bench_now() - start;
+
+    if (items.size != count) {
+        printf("traversed %d of %d nodes\n", items.size, count);
+    }
+    free(items.nodes);
+    return elapsed / count;
+}
+
+// Compares the traversals on a tree of the given size
+static void bench_traversals(int count) {
+    bst_node_t *tree = bench_large_tree(count);
+
+    printf("%-10d %12.2f %12.2f %12.2f %12.2f\n", count,
+           bench_traversal(tree, count, bst_preorder),
+           bench_traversal(tree, count, bst_morris_preorder),
+           bench_traversal(tree, count, bst_inorder),
+           bench_traversal(tree, count, bst_morris_inorder));
+
+    bst_dispose(&tree);
+}
+
+// Builds, updates and disposes many small trees with and without a pool
+static void bench_pool(const bench_order_t *order) {
+    char keys[BENCH_KEYS];
+    order->fill(keys, BENCH_KEYS);
+    bst_node_content_t content = {.value = NULL, .type = INTEGER};
+
+    // Runs the variants separately so that one does not fragment the heap
+    // for the other
+    double times[2][3] = {{0}};
+    bst_pool_t pool;
+    bst_pool_init(&pool);
+
+    // Round -1 is not measured, the first larger malloc after the traversal
+    // benchmark makes glibc consolidate a million freed nodes
+    for (int pooled = 0; pooled < 2; pooled++) {
+        for (int round = -1; round < BENCH_POOL_TREES; round++) {
+            bst_node_t *tree;
+            bst_init(&tree);
+
+            double start = bench_now();
+            for (int i = 0; i < BENCH_KEYS; i++) {
+                if (pooled) {
+                    bst_pool_insert(&pool, &tree, keys[i], content);
+                } else {
+                    bst_insert(&tree, keys[i], content);
+                }
+            }
+            double middle = bench_now();
+            for (int i = 0; i < BENCH_KEYS; i++) {
+                if (pooled) {
+                    bst_pool_insert(&pool, &tree, keys[i], content);
+                } else {
+                    bst_insert(&tree, keys[i], content);
+                }
+            }
+            double end = bench_now();
+            if (pooled) {
+                bst_pool_dispose(&pool, &tree);
+            } else {
+                bst_dispose(&tree);
+            }
+            if (round < 0) {
+                continue;
+            }
+
+            times[pooled][0] += middle - start;
+            times[pooled][1] += end - middle;
+            times[pooled][2] += bench_now() - end;
+        }
+    }
+
+    double nodes = (double)BENCH_KEYS * BENCH_POOL_TREES;
+    for (int pooled = 0; pooled < 2; pooled++) {
+        printf("%-10s %6s %12.1f %12.1f %12.1f\n",
+               pooled ? "" : order->name, pooled ? "pool" : "malloc",
+               times[pooled][0] / nodes, times[pooled][1] / nodes,
+               times[pooled][2] / nodes);
+    }
+}
+
+/*
+ * Vyhledání v podobě bst_search pro celočíselné klíče velkých stromů.
+ */
+static bst_node_content_t *bench_pointer_search(bst_node_t *tree, int key) {
+    while (tree != NULL) {
+        if (key == tree->key) {
+            return &tree->content;
+        }
+        tree = key < tree->key ? tree->left : tree->right;
+    }
+    return NULL;
+}
+
+// Returns BENCH_SEARCHES keys of the tree in random order
+static int *bench_search_keys(bst_node_t *tree) {
+    bst_items_t items = {.nodes = NULL, .capacity = 0, .size = 0};
+    bst_inorder(tree, &items);
+
+    int *keys = malloc(BENCH_SEARCHES * sizeof(int));
+    for (int i = 0; i < BENCH_SEARCHES; i++) {
+        keys[i] = items.nodes[bench_random() % (unsigned)items.size]->key;
+    }
+    free(items.nodes);
+    return keys;
+}
+
+// Returns the time of BENCH_SEARCHES pointer tree searches
+static double bench_pointer_searches(bst_node_t *tree, const int keys[]) {
+    int found = 0;
+    double start = bench_now();
+    for (int i = 0; i < BENCH_SEARCHES; i++) {
+        found += bench_pointer_search(tree, keys[i]) != NULL;
+    }
+    double elapsed = bench_now() - start;
+
+    // Keeps the compiler from optimizing the searches away
+    if (found != BENCH_SEARCHES) {
+        printf("missing keys: %d\n", BENCH_SEARCHES - found);
+    }
+    return elapsed;
+}
+
+// Compares searches in the pointer tree and in its frozen copy
+static void bench_frozen(int count) {
+    bst_node_t *tree = bench_large_tree(count);
+    int *keys = bench_search_keys(tree);
+
+    double start = bench_now();
+    bst_frozen_t frozen;
+    bst_freeze(tree, &frozen);
+    double freeze = bench_now() - start;
+
+    double pointer = bench_pointer_searches(tree, keys);
+
+    int found = 0;
+    bst_node_content_t *content = NULL;
+    start = bench_now();
+    for (int i = 0; i < BENCH_SEARCHES; i++) {
+        found += bst_frozen_search(&frozen, keys[i], &content);
+    }
+    double frozen_search = bench_now() - start;
+
+    if (found != BENCH_SEARCHES) {
+        printf("missing keys: %d\n", BENCH_SEARCHES - found);
+    }
+    printf("%-10d %12.1f %12.1f %12.1f\n", count,
+           pointer / BENCH_SEARCHES,
+           frozen_search / BENCH_SEARCHES, freeze / count);
+
+    bst_frozen_dispose(&frozen);
+    free(keys);
+    bst_dispose(&tree);
+}
+
+// Compares searches in the pointer tree and in a B+ tree with the same keys
+static void bench_bplus(int count) {
+    bst_node_t *tree = bench_large_tree(count);
+    int *keys = bench_search_keys(tree);
+    bst_items_t items = {.nodes = NULL, .capacity = 0, .size = 0};
+    bst_preorder(tree, &items);
+
+    // Inserts the keys in the order the pointer tree got them
+    bst_node_content_t content = {.value = NULL, .type = INTEGER};
+    bplus_node_t *bplus;
+    bplus_init(&bplus);
+    double start = bench_now();
+    for (int i = 0; i < items.size; i++) {
+        bplus_insert(&bplus, items.nodes[i]->key, content);
+    }
+    double insert = bench_now() - start;
+
+    double pointer = bench_pointer_searches(tree, keys);
+
+    int found = 0;
+    bst_node_content_t *value = NULL;
+    start = bench_now();
+    for (int i = 0; i < BENCH_SEARCHES; i++) {
+        found += bplus_search(bplus, keys[i], &value);
+    }
+    double bplus_search_time = bench_now() - start;
+
+    start = bench_now();
+    for (int i = 0; i < items.size; i++) {
+        bplus_delete(&bplus, items.nodes[i]->key);
+    }
+    double delete = bench_now() - start;
+
+    if (found != BENCH_SEARCHES) {
+        printf("missing keys: %d\n", BENCH_SEARCHES - found);
+    }
+    printf("%-10d %12.1f %12.1f %12.1f %12.1f\n", count,
+           pointer / BENCH_SEARCHES, bplus_search_time / BENCH_SEARCHES,
+           insert / items.size, delete / items.size);
+
+    bplus_dispose(&bplus);
+    free(items.nodes);
+    free(keys);
+    bst_dispose(&tree);
+}
+
+// Comparator called through a pointer the compiler cannot see through
+static int bench_compare_i64(int64_t a, int64_t b) {
+    return BST_KEYED_COMPARE_INTEGER(a, b);
+}
+static int (*volatile bench_compare)(int64_t, int64_t) = bench_compare_i64;
+
+BST_KEYED_DEC(int64_t, indirect)
+BST_KEYED_DEF(int64_t, indirect, bench_compare, BST_KEYED_COPY_VALUE,
+              BST_KEYED_FREE_NOTHING)
+
+/*
+ * Změří vkládání a vyhledávání ve stromu s klíči typu K a infixem KNAME,
+ * klíče se berou z pole keys. Výsledky v ns na operaci uloží do insert a
+ * search.
+ */
+#define BENCH_KEYED(KNAME, keys, insert, search)                               \
+  do {                                                                         \
+    bst_node_content_t content = {.value = NULL, .type = INTEGER};             \
+    bst_##KNAME##_node_t *tree;                                                \
+    bst_##KNAME##_init(&tree);                                                 \
+                                                                               \
+    double start = bench_now();                                                \
+    for (int i = 0; i < BENCH_KEYED_KEYS; i++) {                               \
+      bst_##KNAME##_insert(&tree, keys[i], content);                           \
+    }                                                                          \
+    insert = (bench_now() - start) / BENCH_KEYED_KEYS;                         \
+                                                                               \
+    int found = 0;                                                             \
+    bst_node_content_t *value = NULL;                                          \
+    start = bench_now();                                                       \
+    for (int i = 0; i < BENCH_SEARCHES; i++) {                                 \
+      found += bst_##KNAME##_search(tree, keys[i % BENCH_KEYED_KEYS], &value); \
+    }                                                                          \
+    search = (bench_now() - start) / BENCH_SEARCHES;                           \
+                                                                               \
+    if (found != BENCH_SEARCHES) {                                             \
+      printf("missing keys: %d\n", BENCH_SEARCHES - found);                    \
+    }                                                                          \
+    bst_##KNAME##_dispose(&tree);                                              \
+  } while (0)
+
+// Compares trees with direct, indirect and string key comparison
+static void bench_keyed(void) {
+    int64_t *keys = malloc(BENCH_KEYED_KEYS * sizeof(int64_t));
+    char (*strings)[24] = malloc(BENCH_KEYED_KEYS * sizeof(*strings));
+    const char **string_keys = malloc(BENCH_KEYED_KEYS * sizeof(char *));
+    for (int i = 0; i < BENCH_KEYED_KEYS; i++) {
+        keys[i] = (int64_t)bench_random() << 32 | bench_random();
+        sprintf(strings[i], "%016llx", (unsigned long long)keys[i]);
+        string_keys[i] = strings[i];
+    }
+
+    double insert;
+    double search;
+    BENCH_KEYED(i64, keys, insert, search);
+    printf("%-10s %12.1f %12.1f\n", "int64_t", insert, search);
+    BENCH_KEYED(indirect, keys, insert, search);
+    printf("%-10s %12.1f %12.1f\n", "pointer", insert, search);
+    BENCH_KEYED(str, string_keys, insert, search);
+    printf("%-10s %12.1f %12.1f\n", "string", insert, search);
+
+    free(string_keys);
+    free(strings);
+    free(keys);
+}
+
+// Compares range queries with filtering a full inorder traversal
+static void bench_range(int count) {
+    bst_node_t *tree = bench_large_tree(count);
+    bst_items_t items = {.nodes = NULL, .capacity = 0, .size = 0};
+
+    // Keys are spread over [0, 2^31), one range holds about BENCH_RANGE_KEYS
+    int width = (int)(2147483648.0 / count * BENCH_RANGE_KEYS);
+    int lows[BENCH_RANGES];
+    for (int i = 0; i < BENCH_RANGES; i++) {
+        lows[i] = (int)(bench_random() >> 1) - width / 2;
+    }
+
+    // The full traversal is the same for every range, a few are enough
+    int inorder_found = 0;
+    int inorder_queries = BENCH_RANGES / 100;
+    double start = bench_now();
+    for (int i = 0; i < inorder_queries; i++) {
+        items.size = 0;
+        bst_inorder(tree, &items);
+        for (int j = 0; j < items.size; j++) {
+            int key = items.nodes[j]->key;
+            inorder_found += lows[i] <= key && key <= lows[i] + width;
+        }
+    }
+    double inorder = (bench_now() - start) / inorder_queries;
+
+    int range_found = 0;
+    int range_checked = 0;
+    start = bench_now();
+    for (int i = 0; i < BENCH_RANGES; i++) {
+        items.size = 0;
+        bst_range(tree, lows[i], lows[i] + width, &items);
+        range_found += items.size;
+        if (i == inorder_queries - 1) {
+            range_checked = range_found;
+        }
+    }
+    double range = (bench_now() - start) / BENCH_RANGES;
+
+    int cursor_found = 0;
+    start = bench_now();
+    for (int i = 0; i < BENCH_RANGES; i++) {
+        for (bst_node_t *node = bst_lower_bound(tree, lows[i]);
+             node != NULL && node->key <= lows[i] + width;
+             node = bst_next(tree, node)) {
+            cursor_found++;
+        }
+    }
+    double cursor = (bench_now() - start) / BENCH_RANGES;
+
+    // All three ways have to find the same keys
+    if (inorder_found != range_checked || cursor_found != range_found) {
+        printf("inorder found %d of %d, cursor %d of %d\n", inorder_found,
+               range_checked, cursor_found, range_found);
+    }
+    printf("%-10d %12.1f %12.1f %12.1f %12.1f\n", count, inorder / 1000,
+           range / 1000, cursor / 1000, (double)range_found / BENCH_RANGES);
+
+    free(items.nodes);
+    bst_dispose(&tree);
+}
+
+// Returns the time of collecting the first limit inorder nodes into items
+static double bench_items_first(bst_node_t *tree, int limit) {
+    double start = bench_now();
+    bst_items_t items = {.nodes = NULL, .capacity = 0, .size = 0};
+    bst_inorder(tree, &items);
+    int found = items.size < limit ? items.size : limit;
+    free(items.nodes);
+    double elapsed = bench_now() - start;
+
+    if (found != limit) {
+        printf("traversed %d of %d nodes\n", found, limit);
+    }
+    return elapsed;
+}
+
+// Returns the time of visiting the first limit inorder nodes by an iterator
+static double bench_iterator_first(bst_node_t *tree, int limit) {
+    double start = bench_now();
+    bst_iterator_t iterator;
+    bst_iterator_init(&iterator, tree, BST_INORDER);
+    int found = 0;
+    while (found < limit && bst_iterator_next(&iterator) != NULL) {
+        found++;
+    }
+    bst_iterator_done(&iterator);
+    double elapsed = bench_now() - start;
+
+    if (found != limit) {
+        printf("traversed %d of %d nodes\n", found, limit);
+    }
+    return elapsed;
+}
+
+// Compares full and early stopped inorder traversals with and without items
+static void bench_iterator(int count) {
+    bst_node_t *tree = bench_large_tree(count);
+
+    // Not measured, the first large realloc after the previous benchmark
+    // makes glibc consolidate the nodes it freed
+    bench_items_first(tree, count);
+
+    double items = bench_items_first(tree, count);
+    double iterator = bench_iterator_first(tree, count);
+    double items_first = bench_items_first(tree, 10);
+    double iterator_first = bench_iterator_first(tree, 10);
+    printf("%-10d %12.2f %12.2f %12.2f %12.2f\n", count, items / count,
+           iterator / count, items_first / 1000, iterator_first / 1000);
+
+    bst_dispose(&tree);
+}
+
+// Compares inserting shuffled keys with building from the sorted keys
+static void bench_build(int count) {
+    int *keys = malloc(count * sizeof(int));
+    bst_node_content_t *contents = malloc(count * sizeof(bst_node_content_t));
+    for (int i = 0; i < count; i++) {
+        keys[i] = 2 * i;
+        contents[i].value = NULL;
+        contents[i].type = INTEGER;
+    }
+
+    // Builds from sorted keys, the insertion gets them shuffled
+    double times[4];
+    for (int threads = 1, i = 1; threads <= 4; threads *= 2, i++) {
+        bst_node_t *tree;
+        double start = bench_now();
+        bst_build_parallel(&tree, keys, contents, count, threads);
+        times[i] = bench_now() - start;
+        bst_dispose(&tree);
+    }
+
+    for (int i = count - 1; i > 0; i--) {
+        int j = (int)(bench_random() % (unsigned)(i + 1));
+        int swap = keys[i];
+        keys[i] = keys[j];
+        keys[j] = swap;
+    }
+    bst_node_t *tree = NULL;
+    double start = bench_now();
+    for (int i = 0; i < count; i++) {
+        bench_insert(&tree, keys[i]);
+    }
+    times[0] = bench_now() - start;
+    bst_dispose(&tree);
+
+    printf("%-10d %12.1f %12.1f %12.1f %12.1f\n", count, times[0] / count,
+           times[1] / count, times[2] / count, times[3] / count);
+
+    free(contents);
+    free(keys);
+}
+
+// Measures the parallel inorder traversal and dispose with a thread count
+static void bench_parallel(int count, int threads) {
+    bst_node_t *tree = bench_large_tree(count);
+    bst_items_t items = {.nodes = NULL, .capacity = 0, .size = 0};
+
+    // Gives every node a value to free like the trees of the tests
+    bst_inorder(tree, &items);
+    for (int i = 0; i < items.size; i++) {
+        items.nodes[i]->content.value = malloc(sizeof(int));
+    }
+
+    items.size = 0;
+    double start = bench_now();
+    bst_inorder_parallel(tree, &items, threads);
+    double inorder = bench_now() - start;
+    if (items.size != count) {
+        printf("traversed %d of %d nodes\n", items.size, count);
+    }
+    free(items.nodes);
+
+    start = bench_now();
+    bst_dispose_parallel(&tree, threads);
+    double dispose = bench_now() - start;
+
+    printf("%-10d %8d %12.1f %12.1f\n", count, threads, inorder / count,
+           dispose / count);
+}
+
+// Tree shared by the threads of one concurrent benchmark run
+typedef struct bench_shared {
+    bool persistent;            // persistent tree or the locked one
+    bst_persist_t persist;
+    bst_i64_node_t *locked;
+    pthread_rwlock_t lock;      // lock of the locked tree
+    atomic_bool stop;
+} bench_shared_t;
+
+// One thread of a concurrent benchmark run
+typedef struct bench_thread {
+    void *shared;               // state of the run shared by the threads
+    int id;
+    long operations;
+    pthread_t thread;
+} bench_thread_t;
+
+// Per thread xorshift generator, the global one is not thread safe
+static unsigned bench_thread_random(unsigned long long *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return (unsigned)(*state >> 32);
+}
+
+// Searches random keys until the run stops
+static void *bench_snapshot_reader(void *argument) {
+    bench_thread_t *thread = argument;
+    bench_shared_t *shared = thread->shared;
+    unsigned long long state = 0x9E3779B97F4A7C15ULL * (thread->id + 1);
+    long found = 0;
+
+    while (!atomic_load_explicit(&shared->stop, memory_order_relaxed)) {
+        int key = (int)(bench_thread_random(&state) %
+                        (2 * BENCH_CONCURRENT_KEYS));
+        if (shared->persistent) {
+            const bst_node_content_t *content;
+            const bst_persist_node_t *root =
+                bst_persist_read_begin(&shared->persist, thread->id);
+            found += bst_persist_search(root, key, &content);
+            bst_persist_read_end(&shared->persist, thread->id);
+        } else {
+            bst_node_content_t *content;
+            pthread_rwlock_rdlock(&shared->lock);
+            found += bst_i64_search(shared->locked, key, &content);
+            pthread_rwlock_unlock(&shared->lock);
+        }
+        thread->operations++;
+    }
+
+    // Keeps the compiler from optimizing the searches away
+    if (found < 0) {
+        printf("found %ld\n", found);
+    }
+    return NULL;
+}
+
+// Inserts or deletes random keys until the run stops
+static void *bench_snapshot_writer(void *argument) {
+    bench_thread_t *thread = argument;
+    bench_shared_t *shared = thread->shared;
+    unsigned long long state = 0xD1B54A32D192ED03ULL;
+    bst_node_content_t content = {.value = NULL, .type = INTEGER};
+
+    while (!atomic_load_explicit(&shared->stop, memory_order_relaxed)) {
+        unsigned random = bench_thread_random(&state);
+        int key = (int)(random % (2 * BENCH_CONCURRENT_KEYS));
+        bool insert = random >> 31;
+        if (shared->persistent) {
+            if (insert) {
+                bst_persist_insert(&shared->persist, key, content);
+            } else {
+                bst_persist_delete(&shared->persist, key);
+            }
+        } else {
+            pthread_rwlock_wrlock(&shared->lock);
+            if (insert) {
+                bst_i64_insert(&shared->locked, key, content);
+            } else {
+                bst_i64_delete(&shared->locked, key);
+            }
+            pthread_rwlock_unlock(&shared->lock);
+        }
+        thread->operations++;
+    }
+    return NULL;
+}
+
+/*
+ * Spustí readers čtenářů a jednoho zapisujícího nad perzistentním stromem,
+ * nebo nad stromem se zámkem. Do reads a writes uloží počet operací za
+ * sekundu.
+ */
+static void bench_snapshot_run(bool persistent, int readers, double *reads,
+                               double *writes) {
+    bench_shared_t shared = {.persistent = persistent, .locked = NULL};
+    atomic_init(&shared.stop, false);
+    bst_persist_init(&shared.persist);
+    pthread_rwlock_init(&shared.lock, NULL);
+
+    // Fills every other key, the writer keeps about the same count
+    bst_node_content_t content = {.value = NULL, .type = INTEGER};
+    for (int i = 0; i < BENCH_CONCURRENT_KEYS; i++) {
+        int key = (int)(bench_random() % (2 * BENCH_CONCURRENT_KEYS));
+        if (persistent) {
+            bst_persist_insert(&shared.persist, key, content);
+        } else {
+            bst_i64_insert(&shared.locked, key, content);
+        }
+    }
+
+    bench_thread_t threads[BST_PERSIST_READERS + 1];
+    for (int i = 0; i <= readers; i++) {
+        threads[i].shared = &shared;
+        threads[i].id = i;
+        threads[i].operations = 0;
+        pthread_create(&threads[i].thread, NULL,
+                       i < readers ? bench_snapshot_reader
+                                   : bench_snapshot_writer,
+                       &threads[i]);
+    }
+
+    struct timespec duration = {.tv_sec = 0,
+                                .tv_nsec = BENCH_CONCURRENT_MS * 1000000L};
+    nanosleep(&duration, NULL);
+    atomic_store(&shared.stop, true);
+
+    long read_count = 0;
+    for (int i = 0; i <= readers; i++) {
+        pthread_join(threads[i].thread, NULL);
+        if (i < readers) {
+            read_count += threads[i].operations;
+        }
+    }
+    *reads = read_count * 1000.0 / BENCH_CONCURRENT_MS;
+    *writes = threads[readers].operations * 1000.0 / BENCH_CONCURRENT_MS;
+
+    bst_persist_dispose(&shared.persist);
+    bst_i64_dispose(&shared.locked);
+    pthread_rwlock_destroy(&shared.lock);
+}
+
+// Tree shared by the threads of one mixed read and write benchmark run
+typedef struct bench_mixed {
+    bool concurrent;            // tree with node locks or one locked tree
+    bst_concurrent_t tree;
+    bst_i64_node_t *locked;
+    pthread_rwlock_t lock;      // lock of the locked tree
+    unsigned read_percent;      // percentage of the operations that search
+    atomic_bool stop;
+} bench_mixed_t;
+
+// Searches, inserts or deletes random keys until the run stops
+static void *bench_mixed_worker(void *argument) {
+    bench_thread_t *thread = argument;
+    bench_mixed_t *shared = thread->shared;
+    unsigned long long state = 0x9E3779B97F4A7C15ULL * (thread->id + 1);
+    bst_node_content_t content = {.value = NULL, .type = INTEGER};
+    long found = 0;
+
+    while (!atomic_load_explicit(&shared->stop, memory_order_relaxed)) {
+        unsigned random = bench_thread_random(&state);
+        int key = (int)(random % (2 * BENCH_CONCURRENT_KEYS));
+        unsigned operation = (random >> 24) % 100;
+        bool read = operation < shared->read_percent;
+        bool insert = operation % 2 == 0;
+
+        if (shared->concurrent) {
+            bst_node_content_t result;
+            if (read) {
+                found += bst_concurrent_search(&shared->tree, key, &result);
+            } else if (insert) {
+                bst_concurrent_insert(&shared->tree, key, content);
+            } else {
+                bst_concurrent_delete(&shared->tree, key);
+            }
+        } else {
+            bst_node_content_t *result;
+            if (read) {
+                pthread_rwlock_rdlock(&shared->lock);
+                found += bst_i64_search(shared->locked, key, &result);
+            } else {
+                pthread_rwlock_wrlock(&shared->lock);
+                if (insert) {
+                    bst_i64_insert(&shared->locked, key, content);
+                } else {
+                    bst_i64_delete(&shared->locked, key);
+                }
+            }
+            pthread_rwlock_unlock(&shared->lock);
+        }
+        thread->operations++;
+    }
+
+    // Keeps the compiler from optimizing the searches away
+    if (found < 0) {
+        printf("found %ld\n", found);
+    }
+    return NULL;
+}
+
+/*
+ * Spustí threads vláken nad stromem se zámky v uzlech, nebo nad stromem
+ * s jedním zámkem. Vrací počet operací za sekundu.
+ */
+static double bench_mixed_run(bool concurrent, int threads,
+                              unsigned read_percent) {
+    bench_mixed_t shared = {.concurrent = concurrent, .locked = NULL,
+                            .read_percent = read_percent};
+    atomic_init(&shared.stop, false);
+    bst_concurrent_init(&shared.tree);
+    pthread_rwlock_init(&shared.lock, NULL);
+
+    bst_node_content_t content = {.value = NULL, .type = INTEGER};
+    for (int i = 0; i < BENCH_CONCURRENT_KEYS; i++) {
+        int key = (int)(bench_random() % (2 * BENCH_CONCURRENT_KEYS));
+        if (concurrent) {
+            bst_concurrent_insert(&shared.tree, key, content);
+        } else {
+            bst_i64_insert(&shared.locked, key, content);
+        }
+    }
+
+    bench_thread_t workers[BENCH_CONCURRENT_THREADS];
+    for (int i = 0; i < threads; i++) {
+        workers[i].shared = &shared;
+        workers[i].id = i;
+        workers[i].operations = 0;
+        pthread_create(&workers[i].thread, NULL, bench_mixed_worker,
+                       &workers[i]);
+    }
+
+    struct timespec duration = {.tv_sec = 0,
+                                .tv_nsec = BENCH_CONCURRENT_MS * 1000000L};
+    nanosleep(&duration, NULL);
+    atomic_store(&shared.stop, true);
+
+    long operations = 0;
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+        operations += workers[i].operations;
+    }
+
+    bst_concurrent_dispose(&shared.tree);
+    bst_i64_dispose(&shared.locked);
+    pthread_rwlock_destroy(&shared.lock);
+    return operations * 1000.0 / BENCH_CONCURRENT_MS;
+}
+
+// Compares the tree with node locks and the locked tree for the workload
+static void bench_mixed(int threads, unsigned read_percent) {
+    double concurrent = bench_mixed_run(true, threads, read_percent);
+    double locked = bench_mixed_run(false, threads, read_percent);
+    printf("%-10d %-10u %12.2f %12.2f\n", threads, read_percent,
+           concurrent / 1e6, locked / 1e6);
+}
+
+// Compares the persistent and the locked tree with the number of readers
+static void bench_snapshot(int readers) {
+    double persist_reads, persist_writes, locked_reads, locked_writes;
+    bench_snapshot_run(true, readers, &persist_reads, &persist_writes);
+    bench_snapshot_run(false, readers, &locked_reads, &locked_writes);
+    printf("%-10d %12.2f %12.1f %12.2f %12.1f\n", readers, persist_reads / 1e6,
+           persist_writes / 1e3, locked_reads / 1e6, locked_writes / 1e3);
+}
+
+// Counts the characters one by one in the tree, as letter_count used to
+static void bench_letter_count_tree(bst_node_t **tree, const char *text,
+                                    size_t length) {
+    bst_init(tree);
+    for (size_t i = 0; i < length; i++) {
+        char c = text[i];
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        if ((c < 'a' || c > 'z') && c != ' ') {
+            c = '_';
+        }
+
+        bst_node_content_t *result;
+        if (bst_search(*tree, c, &result)) {
+            (*(int *)result->value)++;
+            continue;
+        }
+        bst_node_content_t item = {.value = malloc(sizeof(int)),
+                                   .type = INTEGER};
+        *(int *)item.value = 1;
+        bst_insert(tree, c, item);
+    }
+}
+
+// Returns true if both trees count every character the same
+static bool bench_same_counts(bst_node_t *tree, bst_node_t *expected) {
+    const char keys[] = "abcdefghijklmnopqrstuvwxyz _";
+    for (int i = 0; keys[i] != '\0'; i++) {
+        bst_node_content_t *found;
+        bst_node_content_t *wanted;
+        bool has = bst_search(tree, keys[i], &found);
+        if (has != bst_search(expected, keys[i], &wanted) ||
+            (has && *(int *)found->value != *(int *)wanted->value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Porovná letter_count s počítáním znak po znaku ve stromu na textu
+ * z náhodných slov s velkými písmeny, mezerami, číslicemi a interpunkcí.
+ */
+static void bench_letter_count(void) {
+    const char others[] = "0123456789.,;:!?-_()\"'\n";
+    char *text = malloc(BENCH_TEXT_LENGTH + 1);
+    for (size_t i = 0; i < BENCH_TEXT_LENGTH; i++) {
+        unsigned random = bench_random();
+        if (random % 7 == 0) {
+            text[i] = ' ';
+        } else if (random % 11 == 0) {
+            text[i] = others[(random >> 8) % (sizeof(others) - 1)];
+        } else {
+            text[i] = (random >> 8) % 5 == 0 ? 'A' : 'a';
+            text[i] += (random >> 16) % 26;
+        }
+    }
+    text[BENCH_TEXT_LENGTH] = '\0';
+
+    bst_node_t *tree;
+    double start = bench_now();
+    letter_count(&tree, text);
+    double vectorized = bench_now() - start;
+
+    bst_node_t *expected;
+    start = bench_now();
+    bench_letter_count_tree(&expected, text, BENCH_TEXT_LENGTH);
+    double per_char = bench_now() - start;
+
+    printf("%-14s %14.2f %14.2f %8s\n", "letter_count",
+           BENCH_TEXT_LENGTH / vectorized, BENCH_TEXT_LENGTH / per_char,
+           bench_same_counts(tree, expected) ? "yes" : "NO");
+    bst_dispose(&tree);
+    bst_dispose(&expected);
+    free(text);
+}
+
+int main(int argc, char *argv[]) {
+    printf("Balancing - %d keys\n", BENCH_KEYS);
+    printf("%-10s %8s %12s %8s %12s %12s\n", "order", "height", "ns/search",
+           "height", "ns/search", "balance us");
+    for (int i = 0; i < sizeof(bench_orders) / sizeof(bench_orders[0]); i++) {
+        bench_balance(&bench_orders[i]);
+    }
+
+    printf("\nAVL tree - %d keys\n", BENCH_KEYS);
+    printf("%-10s %6s %12s %12s %12s %8s\n", "order", "tree", "ns/insert",
+           "ns/search", "ns/delete", "height");
+    for (int i = 0; i < sizeof(bench_orders) / sizeof(bench_orders[0]); i++) {
+        bench_avl(&bench_orders[i]);
+    }
+
+    printf("\nTraversals - random trees, ns per node\n");
+    printf("%-10s %12s %12s %12s %12s\n", "nodes", "preorder", "morris pre",
+           "inorder", "morris in");
+    for (int count = BENCH_LARGE_NODES / 100; count <= BENCH_LARGE_NODES;
+         count *= 10) {
+        bench_traversals(count);
+    }
+
+    printf("\nNode pool - %d trees of %d keys, ns per node\n",
+           BENCH_POOL_TREES, BENCH_KEYS);
+    printf("%-10s %6s %12s %12s %12s\n", "order", "nodes", "insert",
+           "update", "dispose");
+    bench_pool(&bench_orders[3]);
+
+    printf("\nFrozen layout - random trees, %d searches\n",
+           BENCH_SEARCHES);
+    printf("%-10s %12s %12s %12s\n", "nodes", "ns/pointer", "ns/frozen",
+           "ns/freeze");
+    for (int count = BENCH_LARGE_NODES / 1000; count <= BENCH_LARGE_NODES;
+         count *= 10) {
+        bench_frozen(count);
+    }
+
+    printf("\nB+ tree - %d keys per node, %d searches\n", BPLUS_KEYS,
+           BENCH_SEARCHES);
+    printf("%-10s %12s %12s %12s %12s\n", "nodes", "ns/pointer", "ns/bplus",
+           "ns/insert", "ns/delete");
+    for (int count = BENCH_LARGE_NODES / 1000; count <= BENCH_LARGE_NODES;
+         count *= 10) {
+        bench_bplus(count);
+    }
+
+    printf("\nKey types - %d random keys\n", BENCH_KEYED_KEYS);
+    printf("%-10s %12s %12s\n", "compare", "ns/insert", "ns/search");
+    bench_keyed();
+
+    printf("\nRange queries - random trees, about %d keys per range\n",
+           BENCH_RANGE_KEYS);
+    printf("%-10s %12s %12s %12s %12s\n", "nodes", "us/inorder", "us/range",
+           "us/cursor", "keys");
+    for (int count = BENCH_LARGE_NODES / 100; count <= BENCH_LARGE_NODES;
+         count *= 10) {
+        bench_range(count);
+    }
+
+    printf("\nInorder iterator - random trees\n");
+    printf("%-10s %12s %12s %12s %12s\n", "nodes", "ns/item", "ns/next",
+           "us/10 items", "us/10 next");
+    for (int count = BENCH_LARGE_NODES / 100; count <= BENCH_LARGE_NODES;
+         count *= 10) {
+        bench_iterator(count);
+    }
+
+    printf("\nBuilding from sorted keys - ns per node\n");
+    printf("%-10s %12s %12s %12s %12s\n", "nodes", "insert", "build",
+           "2 threads", "4 threads");
+    for (int count = BENCH_LARGE_NODES / 100; count <= BENCH_LARGE_NODES;
+         count *= 10) {
+        bench_build(count);
+    }
+
+    printf("\nParallel traversal - random trees, ns per node\n");
+    printf("%-10s %8s %12s %12s\n", "nodes", "threads", "inorder", "dispose");
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        bench_parallel(BENCH_LARGE_NODES, threads);
+    }
+
+    printf("\nSnapshots - %d keys, one writer, M reads/s and k writes/s\n",
+           BENCH_CONCURRENT_KEYS);
+    printf("%-10s %12s %12s %12s %12s\n", "readers", "persist rd",
+           "persist wr", "rwlock rd", "rwlock wr");
+    for (int readers = 1; readers <= 4; readers *= 2) {
+        bench_snapshot(readers);
+    }
+
+    printf("\nMixed operations - %d keys, M operations/s\n",
+           BENCH_CONCURRENT_KEYS);
+    printf("%-10s %-10s %12s %12s\n", "threads", "reads %", "node locks",
+           "one rwlock");
+    for (int threads = 1; threads <= BENCH_CONCURRENT_THREADS; threads *= 2) {
+        bench_mixed(threads, 50);
+        bench_mixed(threads, 90);
+        bench_mixed(threads, 99);
+    }
+
+    printf("\nLetter count - %d MiB of text, GB/s\n",
+           BENCH_TEXT_LENGTH / (1024 * 1024));
+    printf("%-14s %14s %14s %8s\n", "", "vectorized", "per character",
+           "same");
+    bench_letter_count();
+    return 0;
+}
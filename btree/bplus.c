@@ -0,0 +1,436 @@
+/*
+ * B+ strom
+ *
+ * Klíče se v uzlu hledají bez podmíněných skoků podle porovnání: pozice
+ * klíče je počet menších klíčů uzlu, což překladač umí spočítat vektorově.
+ * Vkládání štěpí plné uzly už při sestupu a mazání při sestupu doplní uzly
+ * s nejmenším počtem klíčů, takže se strom nikdy neopravuje zpětně a na
+ * cestě ke kořeni není potřeba zásobník.
+ *
+ * Rozdělovací klíč vnitřního uzlu je nejmenší klíč pravého podstromu v době
+ * štěpení; po smazání tohoto klíče zůstane v uzlu jen jako hranice.
+ */
+
+#include "bplus.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Returns the number of keys of the node smaller than the key
+static int bplus_lower(const bplus_node_t *node, int key) {
+    int position = 0;
+    for (int i = 0; i < node->count; i++) {
+        position += node->keys[i] < key;
+    }
+    return position;
+}
+
+// Returns the number of keys of the node smaller than or equal to the key
+static int bplus_upper(const bplus_node_t *node, int key) {
+    int position = 0;
+    for (int i = 0; i < node->count; i++) {
+        position += node->keys[i] <= key;
+    }
+    return position;
+}
+
+// Allocates an empty node, returns NULL when the allocation fails
+static bplus_node_t *bplus_new_node(bool leaf) {
+    bplus_node_t *node = malloc(sizeof(bplus_node_t));
+    if (node == NULL) {
+        return NULL;
+    }
+    node->count = 0;
+    node->leaf = leaf;
+    node->next = NULL;
+    return node;
+}
+
+/*
+ * Inicializace stromu.
+ */
+void bplus_init(bplus_node_t **tree) {
+    *tree = NULL;
+}
+
+/*
+ * Rozdělí plného potomka index uzlu parent na dva uzly.
+ *
+ * Uzel parent nesmí být plný. Při neúspěšné alokaci vrací false a strom se
+ * nemění.
+ */
+static bool bplus_split_child(bplus_node_t *parent, int index) {
+    bplus_node_t *child = parent->children[index];
+    bplus_node_t *right = bplus_new_node(child->leaf);
+    if (right == NULL) {
+        return false;
+    }
+
+    int separator;
+    if (child->leaf) {
+        // The right leaf starts with a copy of the separator
+        int keep = (BPLUS_KEYS + 1) / 2;
+        right->count = BPLUS_KEYS - keep;
+        memcpy(right->keys, &child->keys[keep], right->count * sizeof(int));
+        memcpy(right->contents, &child->contents[keep],
+               right->count * sizeof(bst_node_content_t));
+        right->next = child->next;
+        child->next = right;
+        child->count = keep;
+        separator = right->keys[0];
+    } else {
+        // The middle key moves up to the parent
+        int keep = BPLUS_KEYS / 2;
+        right->count = BPLUS_KEYS - keep - 1;
+        memcpy(right->keys, &child->keys[keep + 1],
+               right->count * sizeof(int));
+        memcpy(right->children, &child->children[keep + 1],
+               (right->count + 1) * sizeof(bplus_node_t *));
+        child->count = keep;
+        separator = child->keys[keep];
+    }
+
+    memmove(&parent->keys[index + 1], &parent->keys[index],
+            (parent->count - index) * sizeof(int));
+    memmove(&parent->children[index + 2], &parent->children[index + 1],
+            (parent->count - index) * sizeof(bplus_node_t *));
+    parent->keys[index] = separator;
+    parent->children[index + 1] = right;
+    parent->count++;
+    return true;
+}
+
+/*
+ * Vložení klíče do stromu.
+ *
+ * Pokud klíč už ve stromu existuje, uvolní se jeho původní hodnota a
+ * nahradí se novou. Při neúspěšné alokaci se klíč nevloží a strom se
+ * nezmění.
+ */
+void bplus_insert(bplus_node_t **tree, int key, bst_node_content_t value) {
+    if (*tree == NULL) {
+        *tree = bplus_new_node(true);
+        if (*tree == NULL) {
+            return;
+        }
+    }
+
+    // A full root is split under a new root, the tree grows by one level
+    if ((*tree)->count == BPLUS_KEYS) {
+        bplus_node_t *root = bplus_new_node(false);
+        if (root == NULL) {
+            return;
+        }
+        root->children[0] = *tree;
+        if (!bplus_split_child(root, 0)) {
+            free(root);
+            return;
+        }
+        *tree = root;
+    }
+
+    // Splits full children on the way down, so a split never goes back up
+    bplus_node_t *node = *tree;
+    while (!node->leaf) {
+        int index = bplus_upper(node, key);
+        if (node->children[index]->count == BPLUS_KEYS) {
+            if (!bplus_split_child(node, index)) {
+                return;
+            }
+            index += key >= node->keys[index];
+        }
+        node = node->children[index];
+    }
+
+    int position = bplus_lower(node, key);
+    if (position < node->count && node->keys[position] == key) {
+        if (node->contents[position].value != NULL) {
+            free(node->contents[position].value);
+        }
+        node->contents[position] = value;
+        return;
+    }
+
+    memmove(&node->keys[position + 1], &node->keys[position],
+            (node->count - position) * sizeof(int));
+    memmove(&node->contents[position + 1], &node->contents[position],
+            (node->count - position) * sizeof(bst_node_content_t));
+    node->keys[position] = key;
+    node->contents[position] = value;
+    node->count++;
+}
+
+/*
+ * Vyhledání klíče ve stromu.
+ *
+ * Má stejný význam jako bst_search.
+ */
+bool bplus_search(bplus_node_t *tree, int key, bst_node_content_t **value) {
+    // Check if the tree is empty
+    if (tree == NULL) {
+        return false;
+    }
+
+    bplus_node_t *node = tree;
+    while (!node->leaf) {
+        node = node->children[bplus_upper(node, key)];
+    }
+
+    int position = bplus_lower(node, key);
+    if (position == node->count || node->keys[position] != key) {
+        return false;
+    }
+    *value = &node->contents[position];
+    return true;
+}
+
+/*
+ * Sloučí potomka index uzlu parent s jeho pravým sourozencem.
+ *
+ * Oba potomci mají dohromady nejvýše BPLUS_KEYS klíčů včetně rozdělovacího
+ * klíče, pokud nejde o listy.
+ */
+static void bplus_merge_children(bplus_node_t *parent, int index) {
+    bplus_node_t *left = parent->children[index];
+    bplus_node_t *right = parent->children[index + 1];
+
+    if (left->leaf) {
+        memcpy(&left->keys[left->count], right->keys,
+               right->count * sizeof(int));
+        memcpy(&left->contents[left->count], right->contents,
+               right->count * sizeof(bst_node_content_t));
+        left->next = right->next;
+    } else {
+        // The separator comes down between the keys of both nodes
+        left->keys[left->count++] = parent->keys[index];
+        memcpy(&left->keys[left->count], right->keys,
+               right->count * sizeof(int));
+        memcpy(&left->children[left->count], right->children,
+               (right->count + 1) * sizeof(bplus_node_t *));
+    }
+    left->count += right->count;
+    free(right);
+
+    memmove(&parent->keys[index], &parent->keys[index + 1],
+            (parent->count - index - 1) * sizeof(int));
+    memmove(&parent->children[index + 1], &parent->children[index + 2],
+            (parent->count - index - 1) * sizeof(bplus_node_t *));
+    parent->count--;
+}
+
+// Moves the last key of the left sibling to the front of the child
+static void bplus_borrow_left(bplus_node_t *parent, int index) {
+    bplus_node_t *child = parent->children[index];
+    bplus_node_t *left = parent->children[index - 1];
+
+    memmove(&child->keys[1], child->keys, child->count * sizeof(int));
+    if (child->leaf) {
+        memmove(&child->contents[1], child->contents,
+                child->count * sizeof(bst_node_content_t));
+        child->keys[0] = left->keys[left->count - 1];
+        child->contents[0] = left->contents[left->count - 1];
+        parent->keys[index - 1] = child->keys[0];
+    } else {
+        memmove(&child->children[1], child->children,
+                (child->count + 1) * sizeof(bplus_node_t *));
+        child->keys[0] = parent->keys[index - 1];
+        child->children[0] = left->children[left->count];
+        parent->keys[index - 1] = left->keys[left->count - 1];
+    }
+    left->count--;
+    child->count++;
+}
+
+// Moves the first key of the right sibling to the end of the child
+static void bplus_borrow_right(bplus_node_t *parent, int index) {
+    bplus_node_t *child = parent->children[index];
+    bplus_node_t *right = parent->children[index + 1];
+
+    if (child->leaf) {
+        child->keys[child->count] = right->keys[0];
+        child->contents[child->count] = right->contents[0];
+        memmove(right->contents, &right->contents[1],
+                (right->count - 1) * sizeof(bst_node_content_t));
+        memmove(right->keys, &right->keys[1],
+                (right->count - 1) * sizeof(int));
+        parent->keys[index] = right->keys[0];
+    } else {
+        child->keys[child->count] = parent->keys[index];
+        child->children[child->count + 1] = right->children[0];
+        parent->keys[index] = right->keys[0];
+        memmove(right->keys, &right->keys[1],
+                (right->count - 1) * sizeof(int));
+        memmove(right->children, &right->children[1],
+                right->count * sizeof(bplus_node_t *));
+    }
+    right->count--;
+    child->count++;
+}
+
+/*
+ * Doplní potomka index uzlu parent, který má nejmenší povolený počet
+ * klíčů, aby z něj šel jeden klíč odebrat.
+ *
+ * Klíč se přednostně vypůjčí od sourozence, jinak se potomek se
+ * sourozencem sloučí.
+ */
+static void bplus_fill_child(bplus_node_t *parent, int index) {
+    if (index > 0 && parent->children[index - 1]->count > BPLUS_MIN_KEYS) {
+        bplus_borrow_left(parent, index);
+    } else if (index < parent->count &&
+               parent->children[index + 1]->count > BPLUS_MIN_KEYS) {
+        bplus_borrow_right(parent, index);
+    } else if (index > 0) {
+        bplus_merge_children(parent, index - 1);
+    } else {
+        bplus_merge_children(parent, index);
+    }
+}
+
+/*
+ * Odstranění klíče ze stromu.
+ *
+ * Pokud klíč ve stromu neexistuje, funkce strom nanejvýš přeskupí. Hodnota
+ * odstraněného klíče se uvolní.
+ */
+void bplus_delete(bplus_node_t **tree, int key) {
+    // Check if the tree is empty
+    if (*tree == NULL) {
+        return;
+    }
+
+    // Every child is filled before the descent, so a merge never goes back up
+    bplus_node_t *node = *tree;
+    while (!node->leaf) {
+        int index = bplus_upper(node, key);
+        if (node->children[index]->count == BPLUS_MIN_KEYS) {
+            bplus_fill_child(node, index);
+
+            // A root left without keys is replaced by its only child
+            if (node->count == 0) {
+                *tree = node->children[0];
+                free(node);
+                node = *tree;
+                continue;
+            }
+            index = bplus_upper(node, key);
+        }
+        node = node->children[index];
+    }
+
+    int position = bplus_lower(node, key);
+    if (position == node->count || node->keys[position] != key) {
+        return;
+    }
+
+    if (node->contents[position].value != NULL) {
+        free(node->contents[position].value);
+    }
+    memmove(&node->keys[position], &node->keys[position + 1],
+            (node->count - position - 1) * sizeof(int));
+    memmove(&node->contents[position], &node->contents[position + 1],
+            (node->count - position - 1) * sizeof(bst_node_content_t));
+    node->count--;
+
+    // Only the root leaf can become empty
+    if (node->count == 0) {
+        free(node);
+        *tree = NULL;
+    }
+}
+
+/*
+ * Zrušení celého stromu včetně hodnot v listech.
+ */
+void bplus_dispose(bplus_node_t **tree) {
+    // Check if the tree is empty
+    if (*tree == NULL) {
+        return;
+    }
+
+    bplus_node_t *node = *tree;
+    if (node->leaf) {
+        for (int i = 0; i < node->count; i++) {
+            if (node->contents[i].value != NULL) {
+                free(node->contents[i].value);
+            }
+        }
+    } else {
+        for (int i = 0; i <= node->count; i++) {
+            bplus_dispose(&node->children[i]);
+        }
+    }
+
+    free(node);
+    *tree = NULL;
+}
+
+/*
+ * Pomocná funkce pro uložení uzlu stromu do pomocné struktury.
+ */
+void bplus_add_node_to_items(bplus_node_t *node, bplus_items_t *items) {
+    if (items->capacity < items->size + 1) {
+        items->capacity = items->capacity * 2 + 8;
+        items->nodes = realloc(items->nodes,
+                               items->capacity * sizeof(bplus_node_t *));
+    }
+    items->nodes[items->size] = node;
+    items->size++;
+}
+
+/*
+ * Preorder průchod stromem.
+ *
+ * Uzel se uloží před všemi svými potomky.
+ */
+void bplus_preorder(bplus_node_t *tree, bplus_items_t *items) {
+    // Check if pointers to tree and items are valid
+    if (tree == NULL || items == NULL) {
+        return;
+    }
+
+    bplus_add_node_to_items(tree, items);
+    if (!tree->leaf) {
+        for (int i = 0; i <= tree->count; i++) {
+            bplus_preorder(tree->children[i], items);
+        }
+    }
+}
+
+/*
+ * Inorder průchod stromem.
+ *
+ * Všechny hodnoty B+ stromu jsou v listech, průchod proto uloží listy
+ * v pořadí klíčů. Od nejlevějšího listu postupuje po seznamu listů.
+ */
+void bplus_inorder(bplus_node_t *tree, bplus_items_t *items) {
+    // Check if pointers to tree and items are valid
+    if (tree == NULL || items == NULL) {
+        return;
+    }
+
+    while (!tree->leaf) {
+        tree = tree->children[0];
+    }
+    for (; tree != NULL; tree = tree->next) {
+        bplus_add_node_to_items(tree, items);
+    }
+}
+
+/*
+ * Postorder průchod stromem.
+ *
+ * Uzel se uloží po všech svých potomcích.
+ */
+void bplus_postorder(bplus_node_t *tree, bplus_items_t *items) {
+    // Check if pointers to tree and items are valid
+    if (tree == NULL || items == NULL) {
+        return;
+    }
+
+    if (!tree->leaf) {
+        for (int i = 0; i <= tree->count; i++) {
+            bplus_postorder(tree->children[i], items);
+        }
+    }
+    bplus_add_node_to_items(tree, items);
+}
@@ -0,0 +1,52 @@
+/*
+ * Hlavičkový soubor pro B+ strom.
+ *
+ * Uzel B+ stromu nese až BPLUS_KEYS seřazených klíčů, které se spolu
+ * s jejich počtem vejdou do jednoho řádku cache. Hodnoty jsou uloženy jen
+ * v listech, vnitřní uzly obsahují pouze rozdělovací klíče a ukazatele na
+ * potomky. Listy jsou spojeny do seznamu podle klíčů.
+ */
+
+#ifndef IAL_BTREE_BPLUS_H
+#define IAL_BTREE_BPLUS_H
+
+#include "btree.h"
+
+// Největší počet klíčů v uzlu
+#define BPLUS_KEYS 15
+
+// Nejmenší počet klíčů v uzlu kromě kořene
+#define BPLUS_MIN_KEYS (BPLUS_KEYS / 2)
+
+// Uzel B+ stromu
+typedef struct bplus_node {
+  int count;                     // počet klíčů
+  int keys[BPLUS_KEYS];          // seřazené klíče
+  bool leaf;                     // true pro list
+  struct bplus_node *next;       // následující list (jen list)
+  union {
+    struct bplus_node *children[BPLUS_KEYS + 1];  // potomci (vnitřní uzel)
+    bst_node_content_t contents[BPLUS_KEYS];      // hodnoty klíčů (list)
+  };
+} bplus_node_t;
+
+void bplus_init(bplus_node_t **tree);
+void bplus_insert(bplus_node_t **tree, int key, bst_node_content_t value);
+bool bplus_search(bplus_node_t *tree, int key, bst_node_content_t **value);
+void bplus_delete(bplus_node_t **tree, int key);
+void bplus_dispose(bplus_node_t **tree);
+
+// Pole uzlů B+ stromu
+typedef struct bplus_items {
+  bplus_node_t **nodes;   // pole uzlů
+  int capacity;           // kapacita alokované paměti v počtu položek
+  int size;               // aktuální velikost pole v počtu položek
+} bplus_items_t;
+
+void bplus_add_node_to_items(bplus_node_t *node, bplus_items_t *items);
+
+void bplus_preorder(bplus_node_t *tree, bplus_items_t *items);
+void bplus_inorder(bplus_node_t *tree, bplus_items_t *items);
+void bplus_postorder(bplus_node_t *tree, bplus_items_t *items);
+
+#endif
@@ -23,6 +23,7 @@ typedef struct bst_node_content {
 // Uzel stromu
 typedef struct bst_node {
   int key;                     // klíč
+  int height;                  // výška podstromu (jen AVL strom, viz avl.c)
   bst_node_content_t content;  // hodnota
   struct bst_node *left;       // levý potomek
   struct bst_node *right;      // pravý potomek
@@ -47,12 +48,34 @@ void bst_preorder(bst_node_t *tree, bst_items_t *items);
 void bst_inorder(bst_node_t *tree, bst_items_t *items);
 void bst_postorder(bst_node_t *tree, bst_items_t *items);
 
+void bst_preorder_parallel(bst_node_t *tree, bst_items_t *items, int threads);
+void bst_inorder_parallel(bst_node_t *tree, bst_items_t *items, int threads);
+void bst_postorder_parallel(bst_node_t *tree, bst_items_t *items, int threads);
+void bst_dispose_parallel(bst_node_t **tree, int threads);
+
+void bst_morris_preorder(bst_node_t *tree, bst_items_t *items);
+void bst_morris_inorder(bst_node_t *tree, bst_items_t *items);
+
+void bst_range(bst_node_t *tree, int low, int high, bst_items_t *items);
+bool bst_range_each(bst_node_t *tree, int low, int high,
+                    bool (*visit)(bst_node_t *node, void *data), void *data);
+bst_node_t *bst_lower_bound(bst_node_t *tree, int key);
+bst_node_t *bst_next(bst_node_t *tree, bst_node_t *node);
+bst_node_t *bst_prev(bst_node_t *tree, bst_node_t *node);
+
 void bst_replace_by_rightmost(bst_node_t *target, bst_node_t **tree);
 
 void bst_print_node_content(bst_node_content_t *content);
 void bst_print_node(bst_node_t *node);
 
 void bst_balance(bst_node_t **tree);
+bool bst_build(bst_node_t **tree, const int keys[],
+               const bst_node_content_t contents[], int count);
+bool bst_build_parallel(bst_node_t **tree, const int keys[],
+                        const bst_node_content_t contents[], int count,
+                        int threads);
+void bst_avl_insert(bst_node_t **tree, char key, bst_node_content_t value);
+void bst_avl_delete(bst_node_t **tree, char key);
 void letter_count(bst_node_t **letter_frequency_tree, char *input);
 
 #endif
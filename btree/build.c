@@ -0,0 +1,172 @@
+/*
+ * Vytvoření vyváženého stromu ze seřazených klíčů
+ *
+ * Kořenem každého podstromu se stane prostřední z jeho klíčů, takže strom
+ * je dokonale vyvážený a každý uzel se alokuje jednou, přímo na svém
+ * místě. Vytvoření stojí O(n) místo O(n log n) opakovaného vkládání, nebo
+ * O(n^2) pro seřazené klíče v nevyváženém stromu. Uzly mají vyplněnou
+ * výšku, strom lze dál měnit i funkcemi AVL stromu.
+ *
+ * Paralelní varianta vytváří levé poloviny horních úrovní v nových
+ * vláknech.
+ */
+
+#include "btree.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+// Returns the height of the subtree, 0 for an empty one
+static int bst_build_height(bst_node_t *tree) {
+    return tree != NULL ? tree->height : 0;
+}
+
+// Frees the nodes but not the values, those still belong to the caller
+static void bst_build_free(bst_node_t *tree) {
+    if (tree == NULL) {
+        return;
+    }
+    bst_build_free(tree->left);
+    bst_build_free(tree->right);
+    free(tree);
+}
+
+/*
+ * Vytvoří podstrom z klíčů od indexu low do high včetně.
+ *
+ * Při neúspěšné alokaci nastaví failed, podstrom pak může být neúplný.
+ */
+static bst_node_t *bst_build_range(const int keys[],
+                                   const bst_node_content_t contents[],
+                                   int low, int high, bool *failed) {
+    if (low > high) {
+        return NULL;
+    }
+
+    int middle = low + (high - low) / 2;
+    bst_node_t *node = malloc(sizeof(bst_node_t));
+    if (node == NULL) {
+        *failed = true;
+        return NULL;
+    }
+    node->key = keys[middle];
+    node->content = contents[middle];
+    node->left = bst_build_range(keys, contents, low, middle - 1, failed);
+    node->right = bst_build_range(keys, contents, middle + 1, high, failed);
+
+    int left = bst_build_height(node->left);
+    int right = bst_build_height(node->right);
+    node->height = 1 + (left > right ? left : right);
+    return node;
+}
+
+/*
+ * Vytvoření stromu ze seřazených klíčů.
+ *
+ * Klíče keys musí být ostře rostoucí, contents jsou hodnoty na stejných
+ * indexech. Původní obsah tree se nemění ani neuvolňuje. Strom převezme
+ * vlastnictví hodnot. Při neúspěšné alokaci vrací false, tree je prázdný
+ * a hodnoty dál patří volajícímu.
+ */
+bool bst_build(bst_node_t **tree, const int keys[],
+               const bst_node_content_t contents[], int count) {
+    bool failed = false;
+    *tree = bst_build_range(keys, contents, 0, count - 1, &failed);
+    if (failed) {
+        bst_build_free(*tree);
+        *tree = NULL;
+        return false;
+    }
+    return true;
+}
+
+// Part of the keys built by one thread
+typedef struct bst_build_task {
+    const int *keys;
+    const bst_node_content_t *contents;
+    int low;
+    int high;
+    int depth;          // levels that still split into a new thread
+    bst_node_t *tree;   // built subtree
+    bool failed;
+} bst_build_task_t;
+
+/*
+ * Vytvoří podstrom úlohy task. V horních depth úrovních se levý podstrom
+ * vytváří v novém vlákně.
+ */
+static void *bst_build_task(void *argument) {
+    bst_build_task_t *task = argument;
+    if (task->depth == 0 || task->low > task->high) {
+        task->tree = bst_build_range(task->keys, task->contents, task->low,
+                                     task->high, &task->failed);
+        return NULL;
+    }
+
+    int middle = task->low + (task->high - task->low) / 2;
+    bst_build_task_t left = *task;
+    bst_build_task_t right = *task;
+    left.high = middle - 1;
+    right.low = middle + 1;
+    left.depth = right.depth = task->depth - 1;
+
+    // Builds the left half in this thread too if no thread can be started
+    pthread_t thread;
+    bool started = pthread_create(&thread, NULL, bst_build_task, &left) == 0;
+    if (!started) {
+        bst_build_task(&left);
+    }
+    bst_build_task(&right);
+    if (started) {
+        pthread_join(thread, NULL);
+    }
+
+    task->tree = malloc(sizeof(bst_node_t));
+    task->failed = left.failed || right.failed || task->tree == NULL;
+    if (task->tree == NULL) {
+        bst_build_free(left.tree);
+        bst_build_free(right.tree);
+        return NULL;
+    }
+    task->tree->key = task->keys[middle];
+    task->tree->content = task->contents[middle];
+    task->tree->left = left.tree;
+    task->tree->right = right.tree;
+
+    int left_height = bst_build_height(left.tree);
+    int right_height = bst_build_height(right.tree);
+    task->tree->height =
+        1 + (left_height > right_height ? left_height : right_height);
+    return NULL;
+}
+
+/*
+ * Vytvoření stromu ze seřazených klíčů ve více vláknech.
+ *
+ * Má stejný význam jako bst_build, strom vytváří nejvýše threads vláken
+ * (zaokrouhleno dolů na mocninu dvou).
+ */
+bool bst_build_parallel(bst_node_t **tree, const int keys[],
+                        const bst_node_content_t contents[], int count,
+                        int threads) {
+    bst_build_task_t task = {
+        .keys = keys,
+        .contents = contents,
+        .low = 0,
+        .high = count - 1,
+        .depth = 0,
+        .tree = NULL,
+        .failed = false,
+    };
+    while ((2 << task.depth) <= threads) {
+        task.depth++;
+    }
+
+    bst_build_task(&task);
+    if (task.failed) {
+        bst_build_free(task.tree);
+        *tree = NULL;
+        return false;
+    }
+    *tree = task.tree;
+    return true;
+}
@@ -0,0 +1,216 @@
+/*
+ * Souběžný binární vyhledávací strom
+ *
+ * Odkaz na uzel (tree->root nebo ukazatel na potomka) chrání zámek jeho
+ * vlastníka, tedy zámek stromu nebo rodiče. Operace drží zámek vlastníka
+ * odkazu, dokud nezamkne odkazovaný uzel, takže uzel nelze uvolnit mezi
+ * načtením odkazu a zamčením. Vlákna se na cestě navzájem nepředbíhají.
+ *
+ * Uzel se uvolní, jen když zapisující drží zámek jeho rodiče i jeho samého.
+ * Na zámek uzlu pak nikdo jiný nečeká (musel by držet zámek rodiče) a po
+ * odpojení už k uzlu žádná cesta nevede.
+ */
+
+#include "concurrent.h"
+#include <stdlib.h>
+
+// Locks for reading or for writing
+static void bst_concurrent_lock(pthread_rwlock_t *lock, bool write) {
+    if (write) {
+        pthread_rwlock_wrlock(lock);
+    } else {
+        pthread_rwlock_rdlock(lock);
+    }
+}
+
+// Frees the value of the content if it has any
+static void bst_concurrent_free_value(bst_node_content_t *content) {
+    if (content->value != NULL) {
+        free(content->value);
+        content->value = NULL;
+    }
+}
+
+/*
+ * Inicializace stromu.
+ */
+void bst_concurrent_init(bst_concurrent_t *tree) {
+    tree->root = NULL;
+    pthread_rwlock_init(&tree->lock, NULL);
+}
+
+/*
+ * Najde odkaz na uzel s klíčem key, nebo na prázdné místo, kam klíč patří.
+ *
+ * Zámky na cestě předává od kořene. Vrací se zamčeným vlastníkem odkazu,
+ * jehož zámek uloží do owner, a se zamčeným uzlem, pokud ho našla.
+ */
+static bst_concurrent_node_t **bst_concurrent_find(bst_concurrent_t *tree,
+                                                   int key, bool write,
+                                                   pthread_rwlock_t **owner) {
+    pthread_rwlock_t *held = &tree->lock;
+    bst_concurrent_lock(held, write);
+
+    bst_concurrent_node_t **link = &tree->root;
+    while (*link != NULL) {
+        bst_concurrent_node_t *node = *link;
+        bst_concurrent_lock(&node->lock, write);
+        if (key == node->key) {
+            break;
+        }
+        pthread_rwlock_unlock(held);
+        held = &node->lock;
+        link = key < node->key ? &node->left : &node->right;
+    }
+    *owner = held;
+    return link;
+}
+
+/*
+ * Vyhledání uzlu ve stromu.
+ *
+ * Pokud je uzel se zadaným klíčem nalezen, zkopíruje jeho hodnotu do value
+ * a vrací true, jinak vrací false. Na hodnotu, na kterou ukazuje
+ * value->value, se smí přistupovat, jen dokud klíč nikdo neodstraní ani
+ * nepřepíše.
+ */
+bool bst_concurrent_search(bst_concurrent_t *tree, int key,
+                           bst_node_content_t *value) {
+    pthread_rwlock_t *owner;
+    bst_concurrent_node_t **link = bst_concurrent_find(tree, key, false,
+                                                       &owner);
+    bst_concurrent_node_t *node = *link;
+    if (node != NULL) {
+        *value = node->content;
+        pthread_rwlock_unlock(&node->lock);
+    }
+    pthread_rwlock_unlock(owner);
+    return node != NULL;
+}
+
+/*
+ * Vložení uzlu do stromu.
+ *
+ * Má stejný význam jako bst_insert: hodnota existujícího uzlu se nahradí
+ * a původní hodnota se uvolní.
+ */
+void bst_concurrent_insert(bst_concurrent_t *tree, int key,
+                           bst_node_content_t value) {
+    pthread_rwlock_t *owner;
+    bst_concurrent_node_t **link = bst_concurrent_find(tree, key, true,
+                                                       &owner);
+    bst_concurrent_node_t *node = *link;
+
+    // If the keys match, replace its value
+    if (node != NULL) {
+        bst_concurrent_free_value(&node->content);
+        node->content = value;
+        pthread_rwlock_unlock(&node->lock);
+        pthread_rwlock_unlock(owner);
+        return;
+    }
+
+    node = malloc(sizeof(bst_concurrent_node_t));
+    if (node != NULL) {
+        node->key = key;
+        node->content = value;
+        node->left = NULL;
+        node->right = NULL;
+        pthread_rwlock_init(&node->lock, NULL);
+        *link = node;
+    }
+    pthread_rwlock_unlock(owner);
+}
+
+/*
+ * Nahradí zamčený uzel target nejpravějším uzlem jeho levého podstromu.
+ *
+ * Cestu k nejpravějšímu uzlu zamyká s předáváním zámků, target zůstává
+ * zamčený. Nejpravější uzel nahradí jeho levý podstrom a uzel se uvolní.
+ */
+static void bst_concurrent_replace(bst_concurrent_node_t *target) {
+    bst_concurrent_node_t **link = &target->left;
+    bst_concurrent_node_t *rightmost = target->left;
+    pthread_rwlock_wrlock(&rightmost->lock);
+
+    // The lock of the parent of rightmost, unless it is the target
+    pthread_rwlock_t *held = NULL;
+    while (rightmost->right != NULL) {
+        bst_concurrent_node_t *next = rightmost->right;
+        pthread_rwlock_wrlock(&next->lock);
+        if (held != NULL) {
+            pthread_rwlock_unlock(held);
+        }
+        held = &rightmost->lock;
+        link = &rightmost->right;
+        rightmost = next;
+    }
+
+    bst_concurrent_free_value(&target->content);
+    target->key = rightmost->key;
+    target->content = rightmost->content;
+    *link = rightmost->left;
+
+    pthread_rwlock_unlock(&rightmost->lock);
+    pthread_rwlock_destroy(&rightmost->lock);
+    free(rightmost);
+    if (held != NULL) {
+        pthread_rwlock_unlock(held);
+    }
+}
+
+/*
+ * Odstranění uzlu ze stromu.
+ *
+ * Má stejný význam jako bst_delete. Uzel s oběma podstromy se nahradí
+ * nejpravějším uzlem levého podstromu; zámek rodiče se přitom uvolní
+ * hned, protože se mění jen obsah uzlu a ne odkaz na něj.
+ */
+void bst_concurrent_delete(bst_concurrent_t *tree, int key) {
+    pthread_rwlock_t *owner;
+    bst_concurrent_node_t **link = bst_concurrent_find(tree, key, true,
+                                                       &owner);
+    bst_concurrent_node_t *node = *link;
+    if (node == NULL) {
+        pthread_rwlock_unlock(owner);
+        return;
+    }
+
+    if (node->left != NULL && node->right != NULL) {
+        pthread_rwlock_unlock(owner);
+        bst_concurrent_replace(node);
+        pthread_rwlock_unlock(&node->lock);
+        return;
+    }
+
+    // A node with at most one subtree is replaced by that subtree
+    *link = node->left != NULL ? node->left : node->right;
+    pthread_rwlock_unlock(&node->lock);
+    pthread_rwlock_destroy(&node->lock);
+    bst_concurrent_free_value(&node->content);
+    free(node);
+    pthread_rwlock_unlock(owner);
+}
+
+// Frees the nodes of the subtree together with their values
+static void bst_concurrent_free(bst_concurrent_node_t *tree) {
+    if (tree == NULL) {
+        return;
+    }
+    bst_concurrent_free(tree->left);
+    bst_concurrent_free(tree->right);
+    bst_concurrent_free_value(&tree->content);
+    pthread_rwlock_destroy(&tree->lock);
+    free(tree);
+}
+
+/*
+ * Zrušení celého stromu.
+ *
+ * Strom nesmí nikdo číst ani měnit.
+ */
+void bst_concurrent_dispose(bst_concurrent_t *tree) {
+    bst_concurrent_free(tree->root);
+    tree->root = NULL;
+    pthread_rwlock_destroy(&tree->lock);
+}
@@ -0,0 +1,41 @@
+/*
+ * Hlavičkový soubor pro souběžný binární vyhledávací strom.
+ *
+ * Strom mohou současně prohledávat i měnit různá vlákna. Každý uzel má
+ * vlastní zámek čtenářů a zapisujících a operace postupují od kořene
+ * s předáváním zámků (hand-over-hand): zámek potomka se zamkne dřív, než
+ * se odemkne zámek rodiče. Vyhledávání zamyká pro čtení, takže se čtenáři
+ * navzájem neblokují, vložení a odstranění zamykají pro zápis a drží
+ * najednou jen několik sousedních uzlů.
+ */
+
+#ifndef IAL_BTREE_CONCURRENT_H
+#define IAL_BTREE_CONCURRENT_H
+
+#include "btree.h"
+#include <pthread.h>
+
+// Uzel souběžného stromu
+typedef struct bst_concurrent_node {
+  int key;                               // klíč
+  bst_node_content_t content;            // hodnota
+  struct bst_concurrent_node *left;      // levý potomek
+  struct bst_concurrent_node *right;     // pravý potomek
+  pthread_rwlock_t lock;                 // zámek klíče, hodnoty a potomků
+} bst_concurrent_node_t;
+
+// Souběžný strom
+typedef struct bst_concurrent {
+  bst_concurrent_node_t *root;  // kořen
+  pthread_rwlock_t lock;        // zámek ukazatele root
+} bst_concurrent_t;
+
+void bst_concurrent_init(bst_concurrent_t *tree);
+bool bst_concurrent_search(bst_concurrent_t *tree, int key,
+                           bst_node_content_t *value);
+void bst_concurrent_insert(bst_concurrent_t *tree, int key,
+                           bst_node_content_t value);
+void bst_concurrent_delete(bst_concurrent_t *tree, int key);
+void bst_concurrent_dispose(bst_concurrent_t *tree);
+
+#endif
@@ -11,6 +11,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define EXA_AVX2 1
+#endif
+
+// Classes of characters: letters 'a'-'z', space and the others as '_'
+#define _CLASS_COUNT 28
+#define _CLASS_SPACE 26
+#define _CLASS_OTHER 27
+
+// Characters counted at once, new classes are looked up only in them
+#define _CHUNK_SIZE 4096
+
+// Vectors counted in 8-bit counters before they could overflow
+#define _VECTOR_ROUNDS 255
+
 // Convert letter to lowercase
 char _toLower(char c) {
     if (c >= 'A' && c <= 'Z') {
@@ -36,6 +52,159 @@ size_t _len(const char *string) {
     return length;
 }
 
+// Return the class of the character, its index in the counts
+int _classIndex(char c) {
+    c = _categorizeLetter(c);
+    if (c == ' ') {
+        return _CLASS_SPACE;
+    }
+    if (c == '_') {
+        return _CLASS_OTHER;
+    }
+    return c - 'a';
+}
+
+// Return the character representing the class in the tree
+char _classKey(int class) {
+    if (class == _CLASS_SPACE) {
+        return ' ';
+    }
+    if (class == _CLASS_OTHER) {
+        return '_';
+    }
+    return 'a' + class;
+}
+
+// Count the classes of the characters one by one
+void _countScalar(const char *input, size_t length, size_t counts[]) {
+    for (size_t i = 0; i < length; i++) {
+        counts[_classIndex(input[i])]++;
+    }
+}
+
+#ifdef __SSE2__
+// Sum the 8-bit counters of the vector
+size_t _sumSse2(__m128i counters) {
+    __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+    return (size_t)_mm_cvtsi128_si32(sums) +
+           (size_t)_mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums));
+}
+
+/*
+ * Spočítá třídy znaků po 16 znacích.
+ *
+ * Znaky A-Z se po nastavení bitu 0x20 shodují s a-z a žádné jiné ne, takže
+ * každé písmeno stačí porovnat s jednou konstantou. Shody se přičítají do
+ * 8bitových čítačů, které se sečtou dřív, než by mohly přetéct. Ostatní
+ * znaky jsou zbytek do počtu všech znaků.
+ */
+void _countSse2(const char *input, size_t length, size_t counts[]) {
+    size_t i = 0;
+    while (length - i >= 16) {
+        __m128i letters[26];
+        for (int c = 0; c < 26; c++) {
+            letters[c] = _mm_setzero_si128();
+        }
+        __m128i spaces = _mm_setzero_si128();
+
+        size_t rounds = (length - i) / 16;
+        if (rounds > _VECTOR_ROUNDS) {
+            rounds = _VECTOR_ROUNDS;
+        }
+        for (size_t r = 0; r < rounds; r++, i += 16) {
+            __m128i chars = _mm_loadu_si128((const __m128i *)(input + i));
+            __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+            for (int c = 0; c < 26; c++) {
+                __m128i match = _mm_cmpeq_epi8(lower, _mm_set1_epi8('a' + c));
+                letters[c] = _mm_sub_epi8(letters[c], match);
+            }
+            spaces = _mm_sub_epi8(spaces,
+                                  _mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')));
+        }
+
+        size_t counted = 0;
+        for (int c = 0; c < 26; c++) {
+            size_t count = _sumSse2(letters[c]);
+            counts[c] += count;
+            counted += count;
+        }
+        size_t count = _sumSse2(spaces);
+        counts[_CLASS_SPACE] += count;
+        counts[_CLASS_OTHER] += rounds * 16 - counted - count;
+    }
+    _countScalar(input + i, length - i, counts);
+}
+#endif
+
+#ifdef EXA_AVX2
+// Sum the 8-bit counters of the vector
+__attribute__((target("avx2"))) size_t _sumAvx2(__m256i counters) {
+    __m256i sums = _mm256_sad_epu8(counters, _mm256_setzero_si256());
+    return (size_t)_mm256_extract_epi64(sums, 0) +
+           (size_t)_mm256_extract_epi64(sums, 1) +
+           (size_t)_mm256_extract_epi64(sums, 2) +
+           (size_t)_mm256_extract_epi64(sums, 3);
+}
+
+/*
+ * Spočítá třídy znaků po 32 znacích stejně jako _countSse2.
+ */
+__attribute__((target("avx2"))) void _countAvx2(const char *input,
+                                                size_t length,
+                                                size_t counts[]) {
+    size_t i = 0;
+    while (length - i >= 32) {
+        __m256i letters[26];
+        for (int c = 0; c < 26; c++) {
+            letters[c] = _mm256_setzero_si256();
+        }
+        __m256i spaces = _mm256_setzero_si256();
+
+        size_t rounds = (length - i) / 32;
+        if (rounds > _VECTOR_ROUNDS) {
+            rounds = _VECTOR_ROUNDS;
+        }
+        for (size_t r = 0; r < rounds; r++, i += 32) {
+            __m256i chars = _mm256_loadu_si256((const __m256i *)(input + i));
+            __m256i lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+            for (int c = 0; c < 26; c++) {
+                __m256i match =
+                    _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('a' + c));
+                letters[c] = _mm256_sub_epi8(letters[c], match);
+            }
+            spaces = _mm256_sub_epi8(
+                spaces, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')));
+        }
+
+        size_t counted = 0;
+        for (int c = 0; c < 26; c++) {
+            size_t count = _sumAvx2(letters[c]);
+            counts[c] += count;
+            counted += count;
+        }
+        size_t count = _sumAvx2(spaces);
+        counts[_CLASS_SPACE] += count;
+        counts[_CLASS_OTHER] += rounds * 32 - counted - count;
+    }
+    _countScalar(input + i, length - i, counts);
+}
+#endif
+
+// Count the classes with the widest kernel the processor supports
+void _countClasses(const char *input, size_t length, size_t counts[]) {
+#ifdef EXA_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        _countAvx2(input, length, counts);
+        return;
+    }
+#endif
+#ifdef __SSE2__
+    _countSse2(input, length, counts);
+#else
+    _countScalar(input, length, counts);
+#endif
+}
+
 /**
  * Vypočítání frekvence výskytů znaků ve vstupním řetězci.
  * 
@@ -53,27 +222,50 @@ size_t _len(const char *string) {
  * '_'     5
  * 
  * Pro implementaci si můžete v tomto souboru nadefinovat vlastní pomocné funkce.
+ *
+ * Znaky se počítají po blocích vektorovými instrukcemi a do stromu se
+ * vloží až výsledné počty. Třídy se vkládají v pořadí prvního výskytu,
+ * takže strom má stejný tvar jako při vkládání znak po znaku.
 */
 void letter_count(bst_node_t **tree, char *input) {
     bst_init(tree);
 
-    for (int i = 0; i < _len(input); ++i) {
-        char c = _categorizeLetter(input[i]);
+    size_t counts[_CLASS_COUNT] = {0};
+    bool seen[_CLASS_COUNT] = {false};
+    int order[_CLASS_COUNT];
+    int seenCount = 0;
 
-        // Search if character is already in the tree
-        bst_node_content_t* result = NULL;
-        if (bst_search(*tree, c, &result)) {
-            // Increment the character count in the node
-            (*((int*)result->value))++;
-            continue;
+    size_t length = _len(input);
+    for (size_t start = 0; start < length; start += _CHUNK_SIZE) {
+        size_t size = length - start;
+        if (size > _CHUNK_SIZE) {
+            size = _CHUNK_SIZE;
         }
+        _countClasses(input + start, size, counts);
 
-        // Character is not in the tree, insert new node
+        // Look up the order only in chunks where a new class appears
+        bool newClass = false;
+        for (int class = 0; class < _CLASS_COUNT; class++) {
+            newClass |= counts[class] > 0 && !seen[class];
+        }
+        for (size_t i = start; newClass && i < start + size; i++) {
+            int class = _classIndex(input[i]);
+            if (!seen[class]) {
+                seen[class] = true;
+                order[seenCount++] = class;
+            }
+        }
+    }
+
+    for (int i = 0; i < seenCount; i++) {
         bst_node_content_t item = {
                 .type = INTEGER,
                 .value = malloc(sizeof(int))
         };
-        *((int*)(item.value)) = 1;
-        bst_insert(tree, c, item);
+        if (item.value == NULL) {
+            continue;
+        }
+        *((int*)(item.value)) = (int)counts[order[i]];
+        bst_insert(tree, _classKey(order[i]), item);
     }
 }
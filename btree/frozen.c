@@ -0,0 +1,129 @@
+/*
+ * Zmrazený binární vyhledávací strom v Eytzingerově rozložení
+ *
+ * Klíče jsou v poli seřazeny po úrovních jako v binární haldě. Vyhledávání
+ * v každém kroku jen spočítá index potomka z výsledku porovnání, místo
+ * podmíněného skoku, a zároveň načítá do cache blok klíčů o čtyři úrovně
+ * níž. Na konci se z indexu odstraní kroky doprava za hledaným klíčem.
+ *
+ * Zmrazený strom kopíruje jen obaly hodnot, samotné hodnoty zůstávají ve
+ * vlastnictví původního stromu. Dokud se zmrazený strom používá, původní
+ * strom se nesmí měnit ani rušit.
+ */
+
+#include "frozen.h"
+#include <stdlib.h>
+
+// Hints the processor to load the address into the cache
+#if defined(__GNUC__)
+#define BST_FROZEN_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define BST_FROZEN_PREFETCH(address) ((void)(address))
+#endif
+
+// Size of a cache line, one line holds the keys of four levels of a subtree
+#define BST_FROZEN_LINE 64
+
+/*
+ * Uloží uzly podstromu s kořenem na indexu index v pořadí inorder.
+ *
+ * Uzly nodes jsou seřazené, next je index dalšího z nich k uložení.
+ */
+static void bst_frozen_fill(bst_frozen_t *frozen, bst_node_t **nodes,
+                            int *next, int index) {
+    if (index > frozen->count) {
+        return;
+    }
+
+    bst_frozen_fill(frozen, nodes, next, 2 * index);
+    frozen->keys[index] = nodes[*next]->key;
+    frozen->contents[index] = nodes[*next]->content;
+    (*next)++;
+    bst_frozen_fill(frozen, nodes, next, 2 * index + 1);
+}
+
+/*
+ * Zmrazení stromu.
+ *
+ * Vytvoří z tree zmrazený strom se stejnými klíči a obaly hodnot; tree se
+ * nemění. Při neúspěšné alokaci vrací false a frozen je prázdný.
+ */
+bool bst_freeze(bst_node_t *tree, bst_frozen_t *frozen) {
+    frozen->count = 0;
+    frozen->keys = NULL;
+    frozen->contents = NULL;
+
+    bst_items_t items = {.nodes = NULL, .capacity = 0, .size = 0};
+    bst_inorder(tree, &items);
+    if (items.size == 0) {
+        free(items.nodes);
+        return true;
+    }
+
+    // Keys are aligned so that a prefetched block never spans two lines
+    size_t keys_size = (size_t)(items.size + 1) * sizeof(int);
+    keys_size = (keys_size + BST_FROZEN_LINE - 1) / BST_FROZEN_LINE *
+                BST_FROZEN_LINE;
+    frozen->keys = aligned_alloc(BST_FROZEN_LINE, keys_size);
+    frozen->contents = malloc((size_t)(items.size + 1) *
+                              sizeof(bst_node_content_t));
+    if (frozen->keys == NULL || frozen->contents == NULL) {
+        free(items.nodes);
+        bst_frozen_dispose(frozen);
+        return false;
+    }
+
+    frozen->count = items.size;
+    int next = 0;
+    bst_frozen_fill(frozen, items.nodes, &next, 1);
+    free(items.nodes);
+    return true;
+}
+
+/*
+ * Vyhledání uzlu ve zmrazeném stromu.
+ *
+ * Má stejný význam jako bst_search, value ukazuje do zmrazeného stromu.
+ */
+bool bst_frozen_search(const bst_frozen_t *frozen, int key,
+                       bst_node_content_t **value) {
+    const int *keys = frozen->keys;
+    int count = frozen->count;
+
+    // Descends to the left on a match, so the walk ends below the first key
+    // that is not smaller than the searched one
+    unsigned index = 1;
+    while (index <= (unsigned)count) {
+        BST_FROZEN_PREFETCH(keys + 16 * (size_t)index);
+        index = 2 * index + (keys[index] < key);
+    }
+
+    // Drops the trailing right steps and the last left step
+#if defined(__GNUC__)
+    index >>= __builtin_ctz(~index) + 1;
+#else
+    while (index & 1) {
+        index >>= 1;
+    }
+    index >>= 1;
+#endif
+
+    if (index == 0 || keys[index] != key) {
+        return false;
+    }
+    *value = &frozen->contents[index];
+    return true;
+}
+
+/*
+ * Zrušení zmrazeného stromu.
+ *
+ * Hodnoty se neuvolňují, patří původnímu stromu.
+ */
+void bst_frozen_dispose(bst_frozen_t *frozen) {
+    free(frozen->keys);
+    free(frozen->contents);
+    frozen->count = 0;
+    frozen->keys = NULL;
+    frozen->contents = NULL;
+}
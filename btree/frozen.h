@@ -0,0 +1,28 @@
+/*
+ * Hlavičkový soubor pro zmrazený strom.
+ *
+ * Zmrazený strom je kopie hotového stromu jen pro čtení uložená v poli
+ * v Eytzingerově pořadí: kořen je na indexu 1, potomci uzlu k na indexech
+ * 2k a 2k + 1. Klíče jsou uloženy zvlášť od hodnot, takže horní úrovně
+ * stromu se vejdou do několika řádků cache a vyhledávání nepotřebuje
+ * ukazatele ani podmíněné skoky podle porovnání klíčů.
+ */
+
+#ifndef IAL_BTREE_FROZEN_H
+#define IAL_BTREE_FROZEN_H
+
+#include "btree.h"
+
+// Zmrazený strom
+typedef struct bst_frozen {
+  int count;                      // počet uzlů
+  int *keys;                      // klíče od indexu 1 v Eytzingerově pořadí
+  bst_node_content_t *contents;   // hodnoty na stejných indexech jako klíče
+} bst_frozen_t;
+
+bool bst_freeze(bst_node_t *tree, bst_frozen_t *frozen);
+bool bst_frozen_search(const bst_frozen_t *frozen, int key,
+                       bst_node_content_t **value);
+void bst_frozen_dispose(bst_frozen_t *frozen);
+
+#endif
@@ -74,25 +74,11 @@ bool bst_search(bst_node_t *tree, char key, bst_node_content_t **value) {
  * Funkci implementujte iterativně bez použití vlastních pomocných funkcí.
  */
 void bst_insert(bst_node_t **tree, char key, bst_node_content_t value) {
-    // Create a new node
-    bst_node_t *newNode = malloc(sizeof(bst_node_t));
-    if (newNode == NULL) {
-        return;
-    }
-    newNode->key = key;
-    newNode->content = value;
-    newNode->left = NULL;
-    newNode->right = NULL;
-
-    // If the tree is empty, insert the new node as root
-    if (*tree == NULL) {
-        *tree = newNode;
-        return;
-    }
-
     bst_node_t *node = *tree;
+    bst_node_t *previous = NULL;
+
     while (node != NULL) {
-        // If the keys match, replace its value and free the new node
+        // If the keys match, replace its value
         if (key == node->key) {
             if (node->content.value != NULL) {
                 free(node->content.value);
@@ -100,26 +86,37 @@ void bst_insert(bst_node_t **tree, char key, bst_node_content_t value) {
             }
 
             node->content = value;
-            free(newNode);
             return;
         }
 
         // If the key is smaller than the current key continue in left subtree
         // Otherwise continue in the right subtree
+        previous = node;
         if (key < node->key) {
-            if (node->left == NULL) {
-                node->left = newNode;
-                return;
-            }
             node = node->left;
         } else {
-            if (node->right == NULL) {
-                node->right = newNode;
-                return;
-            }
             node = node->right;
         }
     }
+
+    // Create the new node only once its place is known
+    bst_node_t *newNode = malloc(sizeof(bst_node_t));
+    if (newNode == NULL) {
+        return;
+    }
+    newNode->key = key;
+    newNode->content = value;
+    newNode->left = NULL;
+    newNode->right = NULL;
+
+    // If the tree is empty, insert the new node as root
+    if (previous == NULL) {
+        *tree = newNode;
+    } else if (key < previous->key) {
+        previous->left = newNode;
+    } else {
+        previous->right = newNode;
+    }
 }
 
 /*
@@ -294,6 +291,7 @@ void bst_dispose(bst_node_t **tree) {
         free(node);
     }
 
+    stack_bst_dispose(&stack);
     *tree = NULL;
 }
 
@@ -358,6 +356,8 @@ void bst_preorder(bst_node_t *tree, bst_items_t *items) {
         // Continue in the left subtree
         bst_leftmost_preorder(node->left, &stack, items);
     }
+
+    stack_bst_dispose(&stack);
 }
 
 /*
@@ -411,6 +411,8 @@ void bst_inorder(bst_node_t *tree, bst_items_t *items) {
         // Continue in the right subtree
         tree = node->right;
     }
+
+    stack_bst_dispose(&stack);
 }
 
 /*
@@ -476,4 +478,7 @@ void bst_postorder(bst_node_t *tree, bst_items_t *items) {
             bst_add_node_to_items(node, items);
         }
     }
+
+    stack_bst_dispose(&stack);
+    stack_bool_dispose(&first_visit);
 }
@@ -7,7 +7,8 @@
 
 #include "../btree.h"
 
-// Maximální velikost zásobníku
+// Počet položek uložených přímo ve struktuře zásobníku, větší zásobník se
+// přesune do paměti na haldě
 #define MAXSTACK 30
 
 /*
@@ -19,19 +20,27 @@
  *           bst_node_t *stack_bst_pop(stack_bst_t *stack)
  *           bst_node_t *stack_bst_top(stack_bst_t *stack)
  *           bool stack_bst_empty(stack_bst_t *stack)
+ *           void stack_bst_dispose(stack_bst_t *stack)
  * A ekvivalent pro TNAME="bool", T="bool".
+ *
+ * Zásobník nemá omezenou velikost. Prvních MAXSTACK položek se ukládá do
+ * pole inline_items, při zaplnění se položky přesunou do pole na haldě
+ * dvojnásobné velikosti. Paměť na haldě uvolní funkce dispose.
  */
 #define STACKDEC(T, TNAME)                                                     \
   typedef struct {                                                             \
-    T items[MAXSTACK];                                                         \
-    int top;                                                                   \
+    T *items;                /* inline_items nebo pole na haldě */             \
+    int top;                 /* index vrcholu, -1 pro prázdný zásobník */      \
+    int capacity;            /* velikost pole items */                         \
+    T inline_items[MAXSTACK]; /* prvních MAXSTACK položek */                  \
   } stack_##TNAME##_t;                                                         \
                                                                                \
   void stack_##TNAME##_init(stack_##TNAME##_t *stack);                         \
   void stack_##TNAME##_push(stack_##TNAME##_t *stack, T item);                 \
   T stack_##TNAME##_pop(stack_##TNAME##_t *stack);                             \
   T stack_##TNAME##_top(stack_##TNAME##_t *stack);                             \
-  bool stack_##TNAME##_empty(stack_##TNAME##_t *stack);
+  bool stack_##TNAME##_empty(stack_##TNAME##_t *stack);                        \
+  void stack_##TNAME##_dispose(stack_##TNAME##_t *stack);
 
 STACKDEC(bst_node_t *, bst)
 STACKDEC(bool, bool)
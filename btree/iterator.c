@@ -0,0 +1,137 @@
+/*
+ * Postupné průchody stromem
+ *
+ * Zásobník iterátoru obsahuje:
+ *   preorder  — kořeny podstromů, které se ještě mají projít,
+ *   inorder   — uzly cesty, jejichž levý podstrom se právě prochází,
+ *   postorder — uzly cesty od kořene k dalšímu uzlu v pořadí.
+ * Funkce jsou společné pro rekurzivní i iterativní implementaci stromu.
+ */
+
+#include "iterator.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Uloží uzel na zásobník iterátoru.
+ *
+ * Plný zásobník se přesune do pole na haldě dvojnásobné velikosti. Pokud
+ * se to nepodaří, uzel se stejně jako v zásobnících iterativní
+ * implementace zahodí a průchod jeho podstrom vynechá.
+ */
+static void bst_iterator_push(bst_iterator_t *iterator, bst_node_t *node) {
+    if (iterator->top == iterator->capacity - 1) {
+        int capacity = iterator->capacity * 2;
+        bst_node_t **stack;
+        if (iterator->stack == iterator->inline_stack) {
+            stack = malloc(capacity * sizeof(bst_node_t *));
+            if (stack != NULL) {
+                memcpy(stack, iterator->inline_stack,
+                       sizeof(iterator->inline_stack));
+            }
+        } else {
+            stack = realloc(iterator->stack, capacity * sizeof(bst_node_t *));
+        }
+        if (stack == NULL) {
+            return;
+        }
+        iterator->stack = stack;
+        iterator->capacity = capacity;
+    }
+    iterator->stack[++iterator->top] = node;
+}
+
+// Pushes the node and its left descendants for the inorder traversal
+static void bst_iterator_push_left(bst_iterator_t *iterator,
+                                   bst_node_t *node) {
+    for (; node != NULL; node = node->left) {
+        bst_iterator_push(iterator, node);
+    }
+}
+
+// Pushes the way to the first node of the subtree in postorder, a leaf
+static void bst_iterator_push_leaf(bst_iterator_t *iterator,
+                                   bst_node_t *node) {
+    while (node != NULL) {
+        bst_iterator_push(iterator, node);
+        node = node->left != NULL ? node->left : node->right;
+    }
+}
+
+/*
+ * Inicializace iterátoru.
+ *
+ * Iterátor bude procházet strom tree v pořadí order. Strom se během
+ * průchodu nesmí měnit.
+ */
+void bst_iterator_init(bst_iterator_t *iterator, bst_node_t *tree,
+                       bst_order_t order) {
+    iterator->order = order;
+    iterator->stack = iterator->inline_stack;
+    iterator->top = -1;
+    iterator->capacity = BST_ITERATOR_INLINE;
+
+    if (tree == NULL) {
+        return;
+    }
+    switch (order) {
+    case BST_PREORDER:
+        bst_iterator_push(iterator, tree);
+        break;
+    case BST_INORDER:
+        bst_iterator_push_left(iterator, tree);
+        break;
+    case BST_POSTORDER:
+        bst_iterator_push_leaf(iterator, tree);
+        break;
+    }
+}
+
+/*
+ * Vrací další uzel průchodu, nebo NULL po posledním uzlu.
+ */
+bst_node_t *bst_iterator_next(bst_iterator_t *iterator) {
+    if (iterator->top < 0) {
+        return NULL;
+    }
+    bst_node_t *node = iterator->stack[iterator->top--];
+
+    switch (iterator->order) {
+    case BST_PREORDER:
+        // The right subtree goes below the left one
+        if (node->right != NULL) {
+            bst_iterator_push(iterator, node->right);
+        }
+        if (node->left != NULL) {
+            bst_iterator_push(iterator, node->left);
+        }
+        break;
+    case BST_INORDER:
+        bst_iterator_push_left(iterator, node->right);
+        break;
+    case BST_POSTORDER:
+        // After a left child comes the right subtree of the parent
+        if (iterator->top >= 0) {
+            bst_node_t *parent = iterator->stack[iterator->top];
+            if (parent->left == node) {
+                bst_iterator_push_leaf(iterator, parent->right);
+            }
+        }
+        break;
+    }
+    return node;
+}
+
+/*
+ * Ukončení průchodu.
+ *
+ * Uvolní paměť iterátoru; volá se i při průchodu ukončeném předčasně.
+ */
+void bst_iterator_done(bst_iterator_t *iterator) {
+    if (iterator->stack != iterator->inline_stack) {
+        free(iterator->stack);
+    }
+    iterator->stack = iterator->inline_stack;
+    iterator->top = -1;
+    iterator->capacity = BST_ITERATOR_INLINE;
+}
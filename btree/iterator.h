@@ -0,0 +1,40 @@
+/*
+ * Hlavičkový soubor pro postupné průchody stromem.
+ *
+ * Iterátor vrací uzly stromu po jednom v pořadí preorder, inorder nebo
+ * postorder, místo aby je všechny uložil do bst_items_t. Pamatuje si jen
+ * cestu od kořene, takže potřebuje paměť úměrnou výšce stromu, a průchod
+ * lze kdykoli ukončit.
+ */
+
+#ifndef IAL_BTREE_ITERATOR_H
+#define IAL_BTREE_ITERATOR_H
+
+#include "btree.h"
+
+// Počet uzlů cesty uložených přímo ve struktuře iterátoru, delší cesta se
+// přesune do paměti na haldě
+#define BST_ITERATOR_INLINE 32
+
+// Pořadí průchodu
+typedef enum {
+  BST_PREORDER,
+  BST_INORDER,
+  BST_POSTORDER
+} bst_order_t;
+
+// Iterátor
+typedef struct bst_iterator {
+  bst_order_t order;        // pořadí průchodu
+  bst_node_t **stack;       // inline_stack nebo pole na haldě
+  int top;                  // index vrcholu, -1 po posledním uzlu
+  int capacity;             // velikost pole stack
+  bst_node_t *inline_stack[BST_ITERATOR_INLINE]; // prvních uzlů cesty
+} bst_iterator_t;
+
+void bst_iterator_init(bst_iterator_t *iterator, bst_node_t *tree,
+                       bst_order_t order);
+bst_node_t *bst_iterator_next(bst_iterator_t *iterator);
+void bst_iterator_done(bst_iterator_t *iterator);
+
+#endif
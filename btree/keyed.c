@@ -0,0 +1,41 @@
+/*
+ * Binární vyhledávací stromy s celočíselnými a řetězcovými klíči
+ *
+ * Strom s klíči int64_t porovnává klíče přímo. Strom s řetězcovými klíči
+ * porovnává funkcí strcmp a ukládá si vlastní kopie klíčů, takže volající
+ * může svůj řetězec po vložení změnit nebo uvolnit.
+ */
+
+#include "keyed.h"
+#include <string.h>
+
+/*
+ * Uloží do destination kopii řetězce key.
+ *
+ * Při neúspěšné alokaci vrací false.
+ */
+bool bst_keyed_copy_string(const char **destination, const char *key) {
+    size_t size = strlen(key) + 1;
+    char *copy = malloc(size);
+    if (copy == NULL) {
+        return false;
+    }
+    memcpy(copy, key, size);
+    *destination = copy;
+    return true;
+}
+
+/*
+ * Uvolní kopii řetězce vytvořenou funkcí bst_keyed_copy_string.
+ */
+void bst_keyed_free_string(const char *key) {
+    free((char *)key);
+}
+
+#define BST_KEYED_COPY_STRING(destination, key)                                \
+  bst_keyed_copy_string(&(destination), key)
+
+BST_KEYED_DEF(int64_t, i64, BST_KEYED_COMPARE_INTEGER, BST_KEYED_COPY_VALUE,
+              BST_KEYED_FREE_NOTHING)
+BST_KEYED_DEF(const char *, str, strcmp, BST_KEYED_COPY_STRING,
+              bst_keyed_free_string)
@@ -0,0 +1,176 @@
+/*
+ * Hlavičkový soubor pro binární vyhledávací stromy s obecnými klíči.
+ *
+ * Funkce bst_insert, bst_search a bst_delete přijímají jen klíče typu char.
+ * Makra BST_KEYED_DEC a BST_KEYED_DEF generují stejný strom pro libovolný
+ * typ klíče; porovnání, kopie a uvolnění klíče jsou parametry maker, takže
+ * se pro celočíselné klíče přeloží přímo do instrukcí bez volání funkcí.
+ */
+
+#ifndef IAL_BTREE_KEYED_H
+#define IAL_BTREE_KEYED_H
+
+#include "btree.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Makro generující deklarace pro strom s klíči typu K a názvovým infixem
+ * KNAME. Pro KNAME="i64" pracující s typem K="int64_t":
+ *   Datové typy bst_i64_node_t
+ *   Funkce void bst_i64_init(bst_i64_node_t **tree)
+ *           void bst_i64_insert(bst_i64_node_t **tree, int64_t key,
+ *                               bst_node_content_t value)
+ *           bool bst_i64_search(bst_i64_node_t *tree, int64_t key,
+ *                               bst_node_content_t **value)
+ *           void bst_i64_delete(bst_i64_node_t **tree, int64_t key)
+ *           void bst_i64_dispose(bst_i64_node_t **tree)
+ * A ekvivalent pro KNAME="str", K="const char *".
+ *
+ * Funkce mají stejný význam jako bst_insert, bst_search, bst_delete a
+ * bst_dispose včetně uvolňování hodnot uzlů.
+ */
+#define BST_KEYED_DEC(K, KNAME)                                                \
+  typedef struct bst_##KNAME##_node {                                          \
+    K key;                              /* klíč */                             \
+    bst_node_content_t content;         /* hodnota */                          \
+    struct bst_##KNAME##_node *left;    /* levý potomek */                     \
+    struct bst_##KNAME##_node *right;   /* pravý potomek */                    \
+  } bst_##KNAME##_node_t;                                                      \
+                                                                               \
+  void bst_##KNAME##_init(bst_##KNAME##_node_t **tree);                        \
+  void bst_##KNAME##_insert(bst_##KNAME##_node_t **tree, K key,                \
+                            bst_node_content_t value);                         \
+  bool bst_##KNAME##_search(bst_##KNAME##_node_t *tree, K key,                 \
+                            bst_node_content_t **value);                       \
+  void bst_##KNAME##_delete(bst_##KNAME##_node_t **tree, K key);               \
+  void bst_##KNAME##_dispose(bst_##KNAME##_node_t **tree);
+
+/*
+ * Makro generující implementaci funkcí deklarovaných makrem BST_KEYED_DEC.
+ *
+ * COMPARE(a, b) vrací záporné číslo, nulu nebo kladné číslo podle toho, zda
+ * je klíč a menší, roven nebo větší než b. COPY(destination, key) uloží do
+ * uzlu kopii klíče a vrací false, pokud se kopie nepodařila. FREE(key)
+ * uvolní kopii klíče. Všechny tři mohou být makra, pak se do funkcí přímo
+ * vloží.
+ *
+ * Funkce jsou iterativní a zrušení stromu nepotřebuje zásobník: levé
+ * podstromy se rotacemi přesouvají doprava, dokud se z kořene nestane
+ * uzel bez levého potomka, který lze uvolnit.
+ */
+#define BST_KEYED_DEF(K, KNAME, COMPARE, COPY, FREE)                           \
+  void bst_##KNAME##_init(bst_##KNAME##_node_t **tree) {                       \
+    *tree = NULL;                                                              \
+  }                                                                            \
+                                                                               \
+  void bst_##KNAME##_insert(bst_##KNAME##_node_t **tree, K key,                \
+                            bst_node_content_t value) {                        \
+    while (*tree != NULL) {                                                    \
+      int order = COMPARE(key, (*tree)->key);                                  \
+      if (order == 0) {                                                        \
+        if ((*tree)->content.value != NULL) {                                  \
+          free((*tree)->content.value);                                        \
+        }                                                                      \
+        (*tree)->content = value;                                              \
+        return;                                                                \
+      }                                                                        \
+      tree = order < 0 ? &(*tree)->left : &(*tree)->right;                     \
+    }                                                                          \
+                                                                               \
+    bst_##KNAME##_node_t *node = malloc(sizeof(bst_##KNAME##_node_t));         \
+    if (node == NULL) {                                                        \
+      return;                                                                  \
+    }                                                                          \
+    if (!COPY(node->key, key)) {                                               \
+      free(node);                                                              \
+      return;                                                                  \
+    }                                                                          \
+    node->content = value;                                                     \
+    node->left = NULL;                                                         \
+    node->right = NULL;                                                        \
+    *tree = node;                                                              \
+  }                                                                            \
+                                                                               \
+  bool bst_##KNAME##_search(bst_##KNAME##_node_t *tree, K key,                 \
+                            bst_node_content_t **value) {                      \
+    while (tree != NULL) {                                                     \
+      int order = COMPARE(key, tree->key);                                     \
+      if (order == 0) {                                                        \
+        *value = &tree->content;                                               \
+        return true;                                                           \
+      }                                                                        \
+      tree = order < 0 ? tree->left : tree->right;                             \
+    }                                                                          \
+    return false;                                                              \
+  }                                                                            \
+                                                                               \
+  void bst_##KNAME##_delete(bst_##KNAME##_node_t **tree, K key) {              \
+    int order;                                                                 \
+    while (*tree != NULL && (order = COMPARE(key, (*tree)->key)) != 0) {       \
+      tree = order < 0 ? &(*tree)->left : &(*tree)->right;                     \
+    }                                                                          \
+    if (*tree == NULL) {                                                       \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    bst_##KNAME##_node_t *node = *tree;                                        \
+    if (node->content.value != NULL) {                                         \
+      free(node->content.value);                                               \
+    }                                                                          \
+    FREE(node->key);                                                           \
+                                                                               \
+    /* A node with at most one subtree is replaced by that subtree */          \
+    if (node->left == NULL || node->right == NULL) {                           \
+      *tree = node->left != NULL ? node->left : node->right;                   \
+      free(node);                                                              \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    /* Moves the rightmost node of the left subtree into the node */           \
+    bst_##KNAME##_node_t **rightmost = &node->left;                            \
+    while ((*rightmost)->right != NULL) {                                      \
+      rightmost = &(*rightmost)->right;                                        \
+    }                                                                          \
+    bst_##KNAME##_node_t *replacement = *rightmost;                            \
+    node->key = replacement->key;                                              \
+    node->content = replacement->content;                                      \
+    *rightmost = replacement->left;                                            \
+    free(replacement);                                                         \
+  }                                                                            \
+                                                                               \
+  void bst_##KNAME##_dispose(bst_##KNAME##_node_t **tree) {                    \
+    bst_##KNAME##_node_t *node = *tree;                                        \
+    while (node != NULL) {                                                     \
+      if (node->left != NULL) {                                                \
+        /* Rotates right until the root has no left subtree */                 \
+        bst_##KNAME##_node_t *left = node->left;                               \
+        node->left = left->right;                                              \
+        left->right = node;                                                    \
+        node = left;                                                           \
+        continue;                                                              \
+      }                                                                        \
+                                                                               \
+      bst_##KNAME##_node_t *right = node->right;                               \
+      if (node->content.value != NULL) {                                       \
+        free(node->content.value);                                             \
+      }                                                                        \
+      FREE(node->key);                                                         \
+      free(node);                                                              \
+      node = right;                                                            \
+    }                                                                          \
+    *tree = NULL;                                                              \
+  }
+
+// Porovnání, kopie a uvolnění celočíselných klíčů
+#define BST_KEYED_COMPARE_INTEGER(a, b) (((a) > (b)) - ((a) < (b)))
+#define BST_KEYED_COPY_VALUE(destination, key) ((destination) = (key), true)
+#define BST_KEYED_FREE_NOTHING(key) ((void)(key))
+
+bool bst_keyed_copy_string(const char **destination, const char *key);
+void bst_keyed_free_string(const char *key);
+
+BST_KEYED_DEC(int64_t, i64)
+BST_KEYED_DEC(const char *, str)
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * Průchody stromem bez zásobníku (Morrisův algoritmus)
+ *
+ * Místo zásobníku si průchod dočasně uloží cestu zpět do prázdného pravého
+ * ukazatele nejpravějšího uzlu levého podstromu ("vlákno"). Při druhé
+ * návštěvě uzlu se vlákno najde, odstraní a průchod pokračuje pravým
+ * podstromem. Strom se tak během průchodu mění, po jeho skončení je ale
+ * v původním stavu. Průchod potřebuje O(1) paměti navíc a každou hranu
+ * projde nejvýše třikrát.
+ *
+ * Během průchodu se strom nesmí číst z jiného vlákna.
+ */
+
+#include "btree.h"
+#include <stddef.h>
+
+/*
+ * Vrací předchůdce uzlu v pořadí inorder, tedy nejpravější uzel levého
+ * podstromu. Zastaví se i na uzlu, jehož pravý ukazatel je už vlákno zpět
+ * na tree.
+ */
+static bst_node_t *bst_morris_predecessor(bst_node_t *tree) {
+    bst_node_t *node = tree->left;
+    while (node->right != NULL && node->right != tree) {
+        node = node->right;
+    }
+    return node;
+}
+
+/*
+ * Inorder průchod stromem bez zásobníku.
+ *
+ * Pro každý uzel zavolá bst_add_node_to_items ve stejném pořadí jako
+ * bst_inorder.
+ */
+void bst_morris_inorder(bst_node_t *tree, bst_items_t *items) {
+    // Check if pointers to tree and items are valid
+    if (tree == NULL || items == NULL) {
+        return;
+    }
+
+    bst_node_t *node = tree;
+    while (node != NULL) {
+        if (node->left == NULL) {
+            // Nothing on the left, visits the node and follows the right link
+            bst_add_node_to_items(node, items);
+            node = node->right;
+            continue;
+        }
+
+        bst_node_t *predecessor = bst_morris_predecessor(node);
+        if (predecessor->right == NULL) {
+            // First visit, threads the way back and descends to the left
+            predecessor->right = node;
+            node = node->left;
+        } else {
+            // Second visit, the left subtree is done, removes the thread
+            predecessor->right = NULL;
+            bst_add_node_to_items(node, items);
+            node = node->right;
+        }
+    }
+}
+
+/*
+ * Preorder průchod stromem bez zásobníku.
+ *
+ * Pro každý uzel zavolá bst_add_node_to_items ve stejném pořadí jako
+ * bst_preorder.
+ */
+void bst_morris_preorder(bst_node_t *tree, bst_items_t *items) {
+    // Check if pointers to tree and items are valid
+    if (tree == NULL || items == NULL) {
+        return;
+    }
+
+    bst_node_t *node = tree;
+    while (node != NULL) {
+        if (node->left == NULL) {
+            bst_add_node_to_items(node, items);
+            node = node->right;
+            continue;
+        }
+
+        bst_node_t *predecessor = bst_morris_predecessor(node);
+        if (predecessor->right == NULL) {
+            // First visit, the node comes before its subtrees
+            bst_add_node_to_items(node, items);
+            predecessor->right = node;
+            node = node->left;
+        } else {
+            // Second visit, removes the thread and continues on the right
+            predecessor->right = NULL;
+            node = node->right;
+        }
+    }
+}
@@ -0,0 +1,255 @@
+/*
+ * Paralelní průchody a zrušení stromu
+ *
+ * Strom se rozdělí na podstromy s kořeny v hloubce BST_PARALLEL_DEPTH
+ * (nebo menší, pokud je vláken málo). Vlákna si podstromy berou postupně,
+ * takže rychlejší vlákno zpracuje víc menších podstromů. Každý podstrom se
+ * projde běžnou funkcí bst_preorder, bst_inorder nebo bst_postorder do
+ * vlastního pole uzlů. Nakonec se horní úrovně stromu projdou v hlavním
+ * vlákně a na místo každého podstromu se vloží jeho pole, takže výsledek
+ * je stejný jako u sekvenčního průchodu.
+ *
+ * Zrušení stromu funguje stejně: podstromy zruší vlákna funkcí bst_dispose,
+ * uzly horních úrovní pak hlavní vlákno.
+ */
+
+#include "btree.h"
+#include "iterator.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Deepest level of the subtree roots, the tree splits into at most 2^depth
+#define BST_PARALLEL_DEPTH 12
+
+// Subtrees per thread, more of them even out subtrees of different sizes
+#define BST_PARALLEL_SUBTREES 8
+
+// Work shared by the threads of one traversal or dispose
+typedef struct bst_parallel_job {
+    bst_node_t **roots;       // subtree roots from left to right
+    bst_items_t *segments;    // traversed nodes of every subtree
+    int count;                // number of subtrees
+    atomic_int next;          // next subtree to take
+    void (*traversal)(bst_node_t *tree, bst_items_t *items);
+} bst_parallel_job_t;
+
+// Returns the level of the subtree roots for the number of threads
+static int bst_parallel_depth(int threads) {
+    int depth = 0;
+    while (depth < BST_PARALLEL_DEPTH &&
+           (1 << depth) < threads * BST_PARALLEL_SUBTREES) {
+        depth++;
+    }
+    return depth;
+}
+
+// Stores the subtree roots at the depth from left to right
+static void bst_parallel_collect(bst_node_t *tree, int depth,
+                                 bst_parallel_job_t *job) {
+    if (tree == NULL) {
+        return;
+    }
+    if (depth == 0) {
+        job->roots[job->count++] = tree;
+        return;
+    }
+    bst_parallel_collect(tree->left, depth - 1, job);
+    bst_parallel_collect(tree->right, depth - 1, job);
+}
+
+// Traverses or disposes subtrees until none is left
+static void *bst_parallel_worker(void *argument) {
+    bst_parallel_job_t *job = argument;
+    int index;
+    while ((index = atomic_fetch_add(&job->next, 1)) < job->count) {
+        if (job->traversal != NULL) {
+            job->traversal(job->roots[index], &job->segments[index]);
+        } else {
+            bst_dispose(&job->roots[index]);
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Zpracuje podstromy úlohy job v threads vláknech včetně volajícího.
+ */
+static void bst_parallel_run(bst_parallel_job_t *job, int threads) {
+    pthread_t *workers = malloc((threads - 1) * sizeof(pthread_t));
+    int started = 0;
+    if (workers != NULL) {
+        while (started < threads - 1 &&
+               pthread_create(&workers[started], NULL, bst_parallel_worker,
+                              job) == 0) {
+            started++;
+        }
+    }
+
+    bst_parallel_worker(job);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+}
+
+/*
+ * Projde horní úrovně stromu v pořadí order a místo podstromů v hloubce
+ * depth vloží do items jejich pole uzlů.
+ */
+static void bst_parallel_merge(bst_node_t *tree, int depth, bst_order_t order,
+                               bst_parallel_job_t *job, int *segment,
+                               bst_items_t *items) {
+    if (tree == NULL) {
+        return;
+    }
+    if (depth == 0) {
+        bst_items_t *nodes = &job->segments[(*segment)++];
+        memcpy(&items->nodes[items->size], nodes->nodes,
+               nodes->size * sizeof(bst_node_t *));
+        items->size += nodes->size;
+        return;
+    }
+
+    if (order == BST_PREORDER) {
+        items->nodes[items->size++] = tree;
+    }
+    bst_parallel_merge(tree->left, depth - 1, order, job, segment, items);
+    if (order == BST_INORDER) {
+        items->nodes[items->size++] = tree;
+    }
+    bst_parallel_merge(tree->right, depth - 1, order, job, segment, items);
+    if (order == BST_POSTORDER) {
+        items->nodes[items->size++] = tree;
+    }
+}
+
+/*
+ * Průchod stromem v pořadí order ve threads vláknech.
+ *
+ * Při neúspěšné alokaci strom projde sekvenčně funkcí traversal.
+ */
+static void bst_parallel_traverse(bst_node_t *tree, bst_items_t *items,
+                                  int threads, bst_order_t order,
+                                  void (*traversal)(bst_node_t *,
+                                                    bst_items_t *)) {
+    // Check if pointers to tree and items are valid
+    if (tree == NULL || items == NULL) {
+        return;
+    }
+
+    int depth = bst_parallel_depth(threads);
+    bst_parallel_job_t job = {.count = 0, .traversal = traversal};
+    atomic_init(&job.next, 0);
+    job.roots = malloc(((size_t)1 << depth) * sizeof(bst_node_t *));
+    job.segments = calloc((size_t)1 << depth, sizeof(bst_items_t));
+    if (threads <= 1 || job.roots == NULL || job.segments == NULL) {
+        free(job.roots);
+        free(job.segments);
+        traversal(tree, items);
+        return;
+    }
+
+    bst_parallel_collect(tree, depth, &job);
+    bst_parallel_run(&job, threads);
+
+    // The top levels have fewer than 2^depth nodes
+    int size = items->size + (1 << depth);
+    for (int i = 0; i < job.count; i++) {
+        size += job.segments[i].size;
+    }
+    if (items->capacity < size) {
+        bst_node_t **nodes = realloc(items->nodes, size * sizeof(bst_node_t *));
+        if (nodes == NULL) {
+            for (int i = 0; i < job.count; i++) {
+                free(job.segments[i].nodes);
+            }
+            free(job.roots);
+            free(job.segments);
+            traversal(tree, items);
+            return;
+        }
+        items->nodes = nodes;
+        items->capacity = size;
+    }
+
+    int segment = 0;
+    bst_parallel_merge(tree, depth, order, &job, &segment, items);
+    for (int i = 0; i < job.count; i++) {
+        free(job.segments[i].nodes);
+    }
+    free(job.roots);
+    free(job.segments);
+}
+
+/*
+ * Paralelní preorder průchod stromem.
+ *
+ * Uloží do items stejné uzly ve stejném pořadí jako bst_preorder, strom
+ * prochází nejvýše threads vláken.
+ */
+void bst_preorder_parallel(bst_node_t *tree, bst_items_t *items,
+                           int threads) {
+    bst_parallel_traverse(tree, items, threads, BST_PREORDER, bst_preorder);
+}
+
+/*
+ * Paralelní inorder průchod stromem.
+ *
+ * Uloží do items stejné uzly ve stejném pořadí jako bst_inorder.
+ */
+void bst_inorder_parallel(bst_node_t *tree, bst_items_t *items, int threads) {
+    bst_parallel_traverse(tree, items, threads, BST_INORDER, bst_inorder);
+}
+
+/*
+ * Paralelní postorder průchod stromem.
+ *
+ * Uloží do items stejné uzly ve stejném pořadí jako bst_postorder.
+ */
+void bst_postorder_parallel(bst_node_t *tree, bst_items_t *items,
+                            int threads) {
+    bst_parallel_traverse(tree, items, threads, BST_POSTORDER, bst_postorder);
+}
+
+// Frees the nodes above the subtree roots, the roots are already disposed
+static void bst_parallel_free_top(bst_node_t *tree, int depth) {
+    if (tree == NULL || depth == 0) {
+        return;
+    }
+    bst_parallel_free_top(tree->left, depth - 1);
+    bst_parallel_free_top(tree->right, depth - 1);
+    if (tree->content.value != NULL) {
+        free(tree->content.value);
+    }
+    free(tree);
+}
+
+/*
+ * Paralelní zrušení celého stromu.
+ *
+ * Má stejný význam jako bst_dispose, strom ruší nejvýše threads vláken.
+ */
+void bst_dispose_parallel(bst_node_t **tree, int threads) {
+    // Check if the tree is empty
+    if (*tree == NULL) {
+        return;
+    }
+
+    int depth = bst_parallel_depth(threads);
+    bst_parallel_job_t job = {.count = 0, .traversal = NULL, .segments = NULL};
+    atomic_init(&job.next, 0);
+    job.roots = malloc(((size_t)1 << depth) * sizeof(bst_node_t *));
+    if (threads <= 1 || job.roots == NULL) {
+        free(job.roots);
+        bst_dispose(tree);
+        return;
+    }
+
+    bst_parallel_collect(*tree, depth, &job);
+    bst_parallel_run(&job, threads);
+    bst_parallel_free_top(*tree, depth);
+    free(job.roots);
+    *tree = NULL;
+}
@@ -0,0 +1,349 @@
+/*
+ * Perzistentní binární vyhledávací strom
+ *
+ * Zapisující se navzájem vylučují zámkem writer, čtenáři zámek nepoužívají.
+ * Každá změna si nejdřív alokuje všechny nové uzly a místo pro nahrazené
+ * uzly, takže neúspěšná alokace strom nezmění, a teprve potom novou verzi
+ * sestaví a zveřejní.
+ *
+ * Uvolňování po epochách: zapisující zveřejní nový kořen, nahrazené uzly
+ * označí aktuální epochou e a epochu zvýší. Čtenář, který ohlásil epochu
+ * e + 1 nebo novější, načetl kořen až po zveřejnění a nahrazené uzly už
+ * nevidí. Uzly epochy e se proto uvolní, jakmile žádný aktivní čtenář
+ * nemá ohlášenou epochu e nebo starší.
+ */
+
+#include "persist.h"
+#include <stdlib.h>
+
+/*
+ * Inicializace stromu.
+ */
+void bst_persist_init(bst_persist_t *tree) {
+    atomic_init(&tree->root, NULL);
+    atomic_init(&tree->epoch, 1);
+    for (int i = 0; i < BST_PERSIST_READERS; i++) {
+        atomic_init(&tree->readers[i].epoch, 0);
+    }
+    pthread_mutex_init(&tree->writer, NULL);
+    tree->retired = NULL;
+    tree->retired_count = 0;
+    tree->retired_capacity = 0;
+}
+
+// Frees the node and, if asked, its value
+static void bst_persist_free(const bst_persist_node_t *node, bool value) {
+    if (value && node->content.value != NULL) {
+        free(node->content.value);
+    }
+    free((bst_persist_node_t *)node);
+}
+
+// Makes room for count more retired nodes, returns false on failure
+static bool bst_persist_reserve(bst_persist_t *tree, int count) {
+    if (tree->retired_count + count <= tree->retired_capacity) {
+        return true;
+    }
+    int capacity = tree->retired_capacity * 2 + count + 8;
+    bst_persist_retired_t *retired =
+        realloc(tree->retired, capacity * sizeof(bst_persist_retired_t));
+    if (retired == NULL) {
+        return false;
+    }
+    tree->retired = retired;
+    tree->retired_capacity = capacity;
+    return true;
+}
+
+// Marks the node replaced in the current epoch, the room is reserved
+static void bst_persist_retire(bst_persist_t *tree,
+                               const bst_persist_node_t *node, bool value) {
+    bst_persist_retired_t *retired = &tree->retired[tree->retired_count++];
+    retired->node = node;
+    retired->value = value;
+    retired->epoch = atomic_load(&tree->epoch);
+}
+
+/*
+ * Zahájí novou epochu a uvolní uzly nahrazené v epochách, které už žádný
+ * aktivní čtenář nemůže vidět.
+ */
+static void bst_persist_advance(bst_persist_t *tree) {
+    atomic_fetch_add(&tree->epoch, 1);
+
+    uint64_t oldest = UINT64_MAX;
+    for (int i = 0; i < BST_PERSIST_READERS; i++) {
+        uint64_t epoch = atomic_load(&tree->readers[i].epoch);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+
+    // Nodes are retired in epoch order, the freed ones form a prefix
+    int freed = 0;
+    while (freed < tree->retired_count &&
+           tree->retired[freed].epoch < oldest) {
+        bst_persist_free(tree->retired[freed].node,
+                         tree->retired[freed].value);
+        freed++;
+    }
+    tree->retired_count -= freed;
+    for (int i = 0; i < tree->retired_count; i++) {
+        tree->retired[i] = tree->retired[i + freed];
+    }
+}
+
+/*
+ * Alokuje count nových uzlů do pole nodes a místo pro retire nahrazených
+ * uzlů. Při neúspěchu nic nealokuje a vrací false.
+ */
+static bool bst_persist_allocate(bst_persist_t *tree,
+                                 bst_persist_node_t **nodes, int count,
+                                 int retire) {
+    if (!bst_persist_reserve(tree, retire)) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        nodes[i] = malloc(sizeof(bst_persist_node_t));
+        if (nodes[i] == NULL) {
+            while (i-- > 0) {
+                free(nodes[i]);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Nahradí ve verzi podstrom na konci cesty ke klíči key podstromem subtree.
+ * Cesta path od kořene má depth předků, ti se zkopírují do uzlů copies.
+ * Vrací kořen nové verze.
+ */
+static const bst_persist_node_t *bst_persist_copy_path(
+    const bst_persist_node_t **path, int depth, bst_persist_node_t **copies,
+    int key, const bst_persist_node_t *subtree) {
+    for (int i = depth - 1; i >= 0; i--) {
+        *copies[i] = *path[i];
+        if (key < path[i]->key) {
+            copies[i]->left = subtree;
+        } else {
+            copies[i]->right = subtree;
+        }
+        subtree = copies[i];
+    }
+    return subtree;
+}
+
+/*
+ * Vložení uzlu do stromu.
+ *
+ * Pokud uzel se zadaným klíčem už existuje, nahradí se v nové verzi uzlem
+ * s novou hodnotou; původní hodnota se uvolní spolu s nahrazeným uzlem.
+ * Při neúspěšné alokaci se strom nezmění.
+ */
+void bst_persist_insert(bst_persist_t *tree, int key,
+                        bst_node_content_t value) {
+    pthread_mutex_lock(&tree->writer);
+    const bst_persist_node_t *root = atomic_load(&tree->root);
+
+    int depth = 0;
+    const bst_persist_node_t *node = root;
+    while (node != NULL && node->key != key) {
+        node = key < node->key ? node->left : node->right;
+        depth++;
+    }
+
+    // The path ends with the node of the key, or with NULL
+    const bst_persist_node_t **path = malloc((depth + 1) * sizeof(*path));
+    bst_persist_node_t **copies = malloc((depth + 1) * sizeof(*copies));
+    if (path == NULL || copies == NULL ||
+        !bst_persist_allocate(tree, copies, depth + 1, depth + 1)) {
+        free(path);
+        free(copies);
+        pthread_mutex_unlock(&tree->writer);
+        return;
+    }
+    path[0] = root;
+    for (int i = 0; i < depth; i++) {
+        path[i + 1] = key < path[i]->key ? path[i]->left : path[i]->right;
+    }
+
+    bst_persist_node_t *leaf = copies[depth];
+    leaf->key = key;
+    leaf->content = value;
+    leaf->left = node != NULL ? node->left : NULL;
+    leaf->right = node != NULL ? node->right : NULL;
+
+    atomic_store(&tree->root,
+                 bst_persist_copy_path(path, depth, copies, key, leaf));
+    for (int i = 0; i < depth; i++) {
+        bst_persist_retire(tree, path[i], false);
+    }
+    if (node != NULL) {
+        bst_persist_retire(tree, node, true);
+    }
+    bst_persist_advance(tree);
+
+    free(path);
+    free(copies);
+    pthread_mutex_unlock(&tree->writer);
+}
+
+/*
+ * Odstranění uzlu ze stromu.
+ *
+ * Pokud uzel se zadaným klíčem neexistuje, funkce nic nedělá. Uzel s oběma
+ * podstromy se stejně jako v bst_delete nahradí nejpravějším uzlem levého
+ * podstromu. Hodnota odstraněného uzlu se uvolní spolu s ním. Při
+ * neúspěšné alokaci se strom nezmění.
+ */
+void bst_persist_delete(bst_persist_t *tree, int key) {
+    pthread_mutex_lock(&tree->writer);
+    const bst_persist_node_t *root = atomic_load(&tree->root);
+
+    int depth = 0;
+    const bst_persist_node_t *node = root;
+    while (node != NULL && node->key != key) {
+        node = key < node->key ? node->left : node->right;
+        depth++;
+    }
+    if (node == NULL) {
+        pthread_mutex_unlock(&tree->writer);
+        return;
+    }
+
+    // Nodes from the left child to the rightmost node of the left subtree
+    int rightmost_depth = 0;
+    if (node->left != NULL && node->right != NULL) {
+        for (const bst_persist_node_t *rightmost = node->left;
+             rightmost != NULL; rightmost = rightmost->right) {
+            rightmost_depth++;
+        }
+    }
+
+    // Ancestors, the node itself and the way to the rightmost node
+    int count = depth + 1 + rightmost_depth;
+    const bst_persist_node_t **path = malloc(count * sizeof(*path));
+    bst_persist_node_t **copies = malloc(count * sizeof(*copies));
+    if (path == NULL || copies == NULL ||
+        !bst_persist_allocate(tree, copies, count, count)) {
+        free(path);
+        free(copies);
+        pthread_mutex_unlock(&tree->writer);
+        return;
+    }
+    path[0] = root;
+    for (int i = 0; i < depth; i++) {
+        path[i + 1] = key < path[i]->key ? path[i]->left : path[i]->right;
+    }
+
+    const bst_persist_node_t *subtree;
+    if (rightmost_depth == 0) {
+        // A node with at most one subtree is replaced by that subtree
+        subtree = node->left != NULL ? node->left : node->right;
+        free(copies[depth]);
+    } else {
+        // The rightmost node of the left subtree takes the place of the node
+        const bst_persist_node_t **way = &path[depth + 1];
+        way[0] = node->left;
+        for (int i = 1; i < rightmost_depth; i++) {
+            way[i] = way[i - 1]->right;
+        }
+        const bst_persist_node_t *rightmost = way[rightmost_depth - 1];
+
+        // Copies the way above the rightmost node, every step goes right
+        const bst_persist_node_t *left = rightmost->left;
+        for (int i = rightmost_depth - 2; i >= 0; i--) {
+            bst_persist_node_t *copy = copies[depth + 1 + i];
+            *copy = *way[i];
+            copy->right = left;
+            left = copy;
+        }
+
+        bst_persist_node_t *replacement = copies[depth];
+        replacement->key = rightmost->key;
+        replacement->content = rightmost->content;
+        replacement->left = left;
+        replacement->right = node->right;
+        free(copies[depth + rightmost_depth]);
+        subtree = replacement;
+    }
+
+    atomic_store(&tree->root,
+                 bst_persist_copy_path(path, depth, copies, key, subtree));
+    for (int i = 0; i < count; i++) {
+        bst_persist_retire(tree, path[i], path[i] == node);
+    }
+    bst_persist_advance(tree);
+
+    free(path);
+    free(copies);
+    pthread_mutex_unlock(&tree->writer);
+}
+
+/*
+ * Zahájení čtení.
+ *
+ * Čtenář s číslem reader (menším než BST_PERSIST_READERS, každé vlákno
+ * jiné) ohlásí aktuální epochu a získá kořen aktuální verze stromu. Verze
+ * zůstane platná do zavolání bst_persist_read_end.
+ */
+const bst_persist_node_t *bst_persist_read_begin(bst_persist_t *tree,
+                                                 int reader) {
+    atomic_store(&tree->readers[reader].epoch, atomic_load(&tree->epoch));
+    return atomic_load(&tree->root);
+}
+
+/*
+ * Ukončení čtení, verze získaná v bst_persist_read_begin se smí uvolnit.
+ */
+void bst_persist_read_end(bst_persist_t *tree, int reader) {
+    atomic_store(&tree->readers[reader].epoch, 0);
+}
+
+/*
+ * Vyhledání uzlu ve verzi stromu s kořenem root.
+ *
+ * Má stejný význam jako bst_search.
+ */
+bool bst_persist_search(const bst_persist_node_t *root, int key,
+                        const bst_node_content_t **value) {
+    while (root != NULL) {
+        if (key == root->key) {
+            *value = &root->content;
+            return true;
+        }
+        root = key < root->key ? root->left : root->right;
+    }
+    return false;
+}
+
+// Frees the nodes of the version together with their values
+static void bst_persist_free_tree(const bst_persist_node_t *tree) {
+    if (tree == NULL) {
+        return;
+    }
+    bst_persist_free_tree(tree->left);
+    bst_persist_free_tree(tree->right);
+    bst_persist_free(tree, true);
+}
+
+/*
+ * Zrušení stromu včetně všech nahrazených uzlů.
+ *
+ * Strom nesmí nikdo číst ani měnit.
+ */
+void bst_persist_dispose(bst_persist_t *tree) {
+    bst_persist_free_tree(atomic_load(&tree->root));
+    atomic_store(&tree->root, NULL);
+
+    for (int i = 0; i < tree->retired_count; i++) {
+        bst_persist_free(tree->retired[i].node, tree->retired[i].value);
+    }
+    free(tree->retired);
+    tree->retired = NULL;
+    tree->retired_count = 0;
+    tree->retired_capacity = 0;
+    pthread_mutex_destroy(&tree->writer);
+}
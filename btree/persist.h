@@ -0,0 +1,69 @@
+/*
+ * Hlavičkový soubor pro perzistentní binární vyhledávací strom.
+ *
+ * Uzly perzistentního stromu se po vytvoření nemění. Vložení i odstranění
+ * zkopírují uzly na cestě od kořene ke změněnému uzlu a novou verzi
+ * stromu zveřejní jedním atomickým zápisem kořene. Čtenáři tak pracují
+ * s verzí, kterou získali, bez zámků a nikdy nevidí rozpracovanou změnu.
+ *
+ * Nahrazené uzly se uvolňují po epochách: čtenář při začátku čtení ohlásí
+ * aktuální epochu ve svém slotu a uzly nahrazené v epoše e se uvolní, až
+ * žádný aktivní čtenář neohlásil epochu e nebo starší.
+ */
+
+#ifndef IAL_BTREE_PERSIST_H
+#define IAL_BTREE_PERSIST_H
+
+#include "btree.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Počet slotů čtenářů, čtenář používá slot se svým číslem
+#define BST_PERSIST_READERS 64
+
+// Uzel perzistentního stromu
+typedef struct bst_persist_node {
+  int key;                               // klíč
+  bst_node_content_t content;            // hodnota
+  const struct bst_persist_node *left;   // levý potomek
+  const struct bst_persist_node *right;  // pravý potomek
+} bst_persist_node_t;
+
+// Nahrazený uzel čekající na uvolnění
+typedef struct bst_persist_retired {
+  const bst_persist_node_t *node;  // uzel
+  bool value;                      // uvolnit i hodnotu uzlu
+  uint64_t epoch;                  // epocha nahrazení
+} bst_persist_retired_t;
+
+// Slot čtenáře, každý v jiném řádku cache
+typedef struct bst_persist_reader {
+  atomic_uint_fast64_t epoch;   // ohlášená epocha, 0 pokud čtenář nečte
+  char padding[64 - sizeof(atomic_uint_fast64_t)];
+} bst_persist_reader_t;
+
+// Perzistentní strom
+typedef struct bst_persist {
+  _Atomic(const bst_persist_node_t *) root;  // aktuální verze
+  atomic_uint_fast64_t epoch;                 // aktuální epocha
+  pthread_mutex_t writer;                     // zámek zapisujících
+  bst_persist_retired_t *retired;             // nahrazené uzly podle epoch
+  int retired_count;                          // počet nahrazených uzlů
+  int retired_capacity;                       // velikost pole retired
+  bst_persist_reader_t readers[BST_PERSIST_READERS]; // sloty čtenářů
+} bst_persist_t;
+
+void bst_persist_init(bst_persist_t *tree);
+void bst_persist_insert(bst_persist_t *tree, int key,
+                        bst_node_content_t value);
+void bst_persist_delete(bst_persist_t *tree, int key);
+void bst_persist_dispose(bst_persist_t *tree);
+
+const bst_persist_node_t *bst_persist_read_begin(bst_persist_t *tree,
+                                                 int reader);
+void bst_persist_read_end(bst_persist_t *tree, int reader);
+bool bst_persist_search(const bst_persist_node_t *root, int key,
+                        const bst_node_content_t **value);
+
+#endif
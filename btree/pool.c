@@ -0,0 +1,165 @@
+/*
+ * Binární vyhledávací strom s uzly z alokátoru po blocích
+ *
+ * Funkce odpovídají bst_insert, bst_delete a bst_dispose včetně uvolňování
+ * hodnot uzlů, uzly ale přidělují a vracejí do alokátoru stromu. Strom
+ * vytvořený těmito funkcemi se smí měnit jen jimi; vyhledávání a průchody
+ * fungují beze změny.
+ */
+
+#include "pool.h"
+#include <stdlib.h>
+
+/*
+ * Inicializace alokátoru — zavolá se před prvním vložením do stromu.
+ */
+void bst_pool_init(bst_pool_t *pool) {
+    pool->blocks = NULL;
+    pool->used = BST_POOL_NODES;
+    pool->free_list = NULL;
+}
+
+/*
+ * Přidělení jednoho uzlu.
+ *
+ * Přednostně se použije naposledy uvolněný uzel, jinak další uzel
+ * nejnovějšího bloku. Při neúspěšné alokaci bloku vrací NULL.
+ */
+bst_node_t *bst_pool_alloc(bst_pool_t *pool) {
+    // Reuses a released node
+    if (pool->free_list != NULL) {
+        bst_node_t *node = pool->free_list;
+        pool->free_list = node->left;
+        return node;
+    }
+
+    // Starts a new block once the newest one is full
+    if (pool->used == BST_POOL_NODES) {
+        bst_pool_block_t *block = malloc(
+            sizeof(bst_pool_block_t) + BST_POOL_NODES * sizeof(bst_node_t));
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next = pool->blocks;
+        pool->blocks = block;
+        pool->used = 0;
+    }
+
+    return &pool->blocks->nodes[pool->used++];
+}
+
+/*
+ * Vrácení uzlu do alokátoru.
+ *
+ * Hodnota uzlu se neuvolňuje, uzel se jen označí jako volný.
+ */
+void bst_pool_free(bst_pool_t *pool, bst_node_t *node) {
+    // Marks the node as free so that dispose skips its content
+    node->content.value = NULL;
+    node->left = pool->free_list;
+    pool->free_list = node;
+}
+
+/*
+ * Vložení uzlu do stromu.
+ *
+ * Pokud uzel se zadaným klíčem už existuje, uvolní se jeho hodnota a
+ * nahradí se novou; alokátor se přitom nevolá. Nový uzel se přidělí až po
+ * nalezení jeho místa.
+ */
+void bst_pool_insert(bst_pool_t *pool, bst_node_t **tree, char key,
+                     bst_node_content_t value) {
+    // Finds the key or the empty place for it
+    while (*tree != NULL) {
+        if (key == (*tree)->key) {
+            if ((*tree)->content.value != NULL) {
+                free((*tree)->content.value);
+            }
+            (*tree)->content = value;
+            return;
+        }
+        tree = key < (*tree)->key ? &(*tree)->left : &(*tree)->right;
+    }
+
+    bst_node_t *node = bst_pool_alloc(pool);
+    if (node == NULL) {
+        return;
+    }
+    node->key = key;
+    node->height = 1;
+    node->content = value;
+    node->left = NULL;
+    node->right = NULL;
+    *tree = node;
+}
+
+/*
+ * Odstranění uzlu ze stromu.
+ *
+ * Pokud uzel se zadaným klíčem neexistuje, funkce nic nedělá. Uzel s oběma
+ * podstromy se stejně jako v bst_delete nahradí nejpravějším uzlem levého
+ * podstromu. Hodnota odstraněného uzlu se uvolní, uzel se vrátí do
+ * alokátoru.
+ */
+void bst_pool_delete(bst_pool_t *pool, bst_node_t **tree, char key) {
+    // Finds the link pointing to the node with the key
+    while (*tree != NULL && key != (*tree)->key) {
+        tree = key < (*tree)->key ? &(*tree)->left : &(*tree)->right;
+    }
+    if (*tree == NULL) {
+        return;
+    }
+
+    bst_node_t *node = *tree;
+    if (node->content.value != NULL) {
+        free(node->content.value);
+    }
+
+    // A node with at most one subtree is replaced by that subtree
+    if (node->left == NULL || node->right == NULL) {
+        *tree = node->left != NULL ? node->left : node->right;
+        bst_pool_free(pool, node);
+        return;
+    }
+
+    // Moves the rightmost node of the left subtree into the node
+    bst_node_t **rightmost = &node->left;
+    while ((*rightmost)->right != NULL) {
+        rightmost = &(*rightmost)->right;
+    }
+    bst_node_t *replacement = *rightmost;
+    node->key = replacement->key;
+    node->content = replacement->content;
+    *rightmost = replacement->left;
+    bst_pool_free(pool, replacement);
+}
+
+/*
+ * Zrušení celého stromu.
+ *
+ * Hodnoty uzlů se uvolní průchodem bloků v pořadí paměti, bez procházení
+ * stromu, a všechny bloky se uvolní najednou. Po zrušení je strom prázdný
+ * a alokátor je možné znovu použít.
+ */
+void bst_pool_dispose(bst_pool_t *pool, bst_node_t **tree) {
+    int used = pool->used;
+
+    while (pool->blocks != NULL) {
+        bst_pool_block_t *block = pool->blocks;
+
+        // Free nodes have their content cleared by bst_pool_free
+        for (int i = 0; i < used; i++) {
+            if (block->nodes[i].content.value != NULL) {
+                free(block->nodes[i].content.value);
+            }
+        }
+
+        // Every older block is full
+        pool->blocks = block->next;
+        used = BST_POOL_NODES;
+        free(block);
+    }
+
+    bst_pool_init(pool);
+    *tree = NULL;
+}
@@ -0,0 +1,39 @@
+/*
+ * Hlavičkový soubor pro alokátor uzlů stromu.
+ *
+ * Uzly jednoho stromu se přidělují z větších bloků, uvolněné uzly se řetězí
+ * do seznamu volných uzlů a znovu se použijí. Celý strom se zruší najednou
+ * uvolněním bloků bez procházení stromu.
+ */
+
+#ifndef IAL_BTREE_POOL_H
+#define IAL_BTREE_POOL_H
+
+#include "btree.h"
+
+// Počet uzlů v jednom bloku
+#define BST_POOL_NODES 256
+
+// Blok uzlů
+typedef struct bst_pool_block {
+  struct bst_pool_block *next; // další (starší) blok
+  bst_node_t nodes[];          // uzly bloku
+} bst_pool_block_t;
+
+// Alokátor uzlů jednoho stromu
+typedef struct bst_pool {
+  bst_pool_block_t *blocks; // seznam bloků, nejnovější první
+  int used;                 // počet použitých uzlů v nejnovějším bloku
+  bst_node_t *free_list;    // uvolněné uzly spojené ukazatelem left
+} bst_pool_t;
+
+void bst_pool_init(bst_pool_t *pool);
+bst_node_t *bst_pool_alloc(bst_pool_t *pool);
+void bst_pool_free(bst_pool_t *pool, bst_node_t *node);
+
+void bst_pool_insert(bst_pool_t *pool, bst_node_t **tree, char key,
+                     bst_node_content_t value);
+void bst_pool_delete(bst_pool_t *pool, bst_node_t **tree, char key);
+void bst_pool_dispose(bst_pool_t *pool, bst_node_t **tree);
+
+#endif
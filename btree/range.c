@@ -0,0 +1,127 @@
+/*
+ * Rozsahové dotazy a posun po uzlech v pořadí klíčů
+ *
+ * bst_range navštíví jen uzly, jejichž podstrom může obsahovat klíč
+ * z rozsahu, takže pro k nalezených uzlů stojí O(h + k) místo průchodu
+ * celým stromem. Uzly stromu nemají ukazatel na rodiče, bst_next a bst_prev
+ * proto uzel bez příslušného podstromu hledají znovu od kořene v čase O(h).
+ */
+
+#include "btree.h"
+#include <stddef.h>
+
+/*
+ * Průchod uzly s klíči v rozsahu.
+ *
+ * Pro každý uzel s klíčem od low do high včetně zavolá v pořadí klíčů
+ * funkci visit s ukazatelem data. Pokud visit vrátí false, průchod skončí
+ * a funkce vrací false, jinak vrací true.
+ */
+bool bst_range_each(bst_node_t *tree, int low, int high,
+                    bool (*visit)(bst_node_t *node, void *data), void *data) {
+    while (tree != NULL) {
+        // Smaller keys are only on the left
+        if (low < tree->key &&
+            !bst_range_each(tree->left, low, high, visit, data)) {
+            return false;
+        }
+        if (low <= tree->key && tree->key <= high && !visit(tree, data)) {
+            return false;
+        }
+
+        // Larger keys are only on the right, continues there without recursion
+        if (tree->key >= high) {
+            break;
+        }
+        tree = tree->right;
+    }
+    return true;
+}
+
+// Adds every visited node to the items passed as data
+static bool bst_range_add(bst_node_t *node, void *data) {
+    bst_add_node_to_items(node, data);
+    return true;
+}
+
+/*
+ * Uložení uzlů s klíči od low do high včetně.
+ *
+ * Pro každý takový uzel zavolá v pořadí klíčů bst_add_node_to_items.
+ */
+void bst_range(bst_node_t *tree, int low, int high, bst_items_t *items) {
+    // Check if pointer to items is valid
+    if (items == NULL) {
+        return;
+    }
+
+    bst_range_each(tree, low, high, bst_range_add, items);
+}
+
+/*
+ * Vrací uzel s nejmenším klíčem, který není menší než key, nebo NULL.
+ */
+bst_node_t *bst_lower_bound(bst_node_t *tree, int key) {
+    bst_node_t *result = NULL;
+    while (tree != NULL) {
+        if (tree->key >= key) {
+            result = tree;
+            tree = tree->left;
+        } else {
+            tree = tree->right;
+        }
+    }
+    return result;
+}
+
+/*
+ * Vrací následníka uzlu node stromu tree v pořadí klíčů, nebo NULL.
+ */
+bst_node_t *bst_next(bst_node_t *tree, bst_node_t *node) {
+    // The successor is the leftmost node of the right subtree
+    if (node->right != NULL) {
+        node = node->right;
+        while (node->left != NULL) {
+            node = node->left;
+        }
+        return node;
+    }
+
+    // Otherwise it is the last node where the way from the root went left
+    bst_node_t *result = NULL;
+    while (tree != node) {
+        if (node->key < tree->key) {
+            result = tree;
+            tree = tree->left;
+        } else {
+            tree = tree->right;
+        }
+    }
+    return result;
+}
+
+/*
+ * Vrací předchůdce uzlu node stromu tree v pořadí klíčů, nebo NULL.
+ */
+bst_node_t *bst_prev(bst_node_t *tree, bst_node_t *node) {
+    // The predecessor is the rightmost node of the left subtree
+    if (node->left != NULL) {
+        node = node->left;
+        while (node->right != NULL) {
+            node = node->right;
+        }
+        return node;
+    }
+
+    // Otherwise it is the last node where the way from the root went right
+    bst_node_t *result = NULL;
+    while (tree != node) {
+        if (node->key < tree->key) {
+            tree = tree->left;
+        } else {
+            result = tree;
+            tree = tree->right;
+        }
+    }
+    return result;
+}
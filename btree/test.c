@@ -1,7 +1,9 @@
 #include "btree.h"
 #include "test_util.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 const int base_data_count = 15;
 const char base_keys[] = {'H', 'D', 'L', 'B', 'F', 'J', 'N', 'A',
@@ -16,6 +18,10 @@ const int traversal_data_count = 5;
 const char traversal_keys[] = {'D', 'B', 'A', 'C', 'E'};
 const int traversal_values[] = {1, 2, 3, 4, 5};
 
+const int sorted_data_count = 15;
+const char sorted_keys[] = {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H',
+                            'I', 'J', 'K', 'L', 'M', 'N', 'O'};
+
 void init_test() {
   printf("Binary Search Tree - testing script\n");
   printf("-----------------------------------\n");
@@ -174,6 +180,453 @@ bst_print_tree(test_tree);
 bst_print_items(test_items);
 ENDTEST
 
+TEST(test_tree_balance_empty, "Balance an empty tree")
+bst_init(&test_tree);
+bst_balance(&test_tree);
+bst_print_tree(test_tree);
+ENDTEST
+
+TEST(test_tree_balance_degenerate, "Balance a tree built from sorted keys")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, sorted_keys, base_values, sorted_data_count);
+bst_print_tree(test_tree);
+bst_balance(&test_tree);
+bst_print_tree(test_tree);
+bst_node_content_t* result = NULL;
+bst_search(test_tree, 'M', &result);
+bst_print_search_result(result);
+ENDTEST
+
+TEST(test_tree_balance_partial, "Balance a tree with an incomplete last level")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, additional_keys, additional_values,
+                additional_data_count);
+bst_insert_many(&test_tree, traversal_keys, traversal_values,
+                traversal_data_count);
+bst_balance(&test_tree);
+bst_inorder(test_tree, test_items);
+bst_print_tree(test_tree);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_avl_insert_sorted, "Insert sorted keys into an AVL tree")
+bst_init(&test_tree);
+for (int i = 0; i < sorted_data_count; i++) {
+  bst_avl_insert(&test_tree, sorted_keys[i],
+                 create_integer_content(base_values[i]));
+}
+bst_avl_insert(&test_tree, 'O', create_integer_content(15));
+bst_print_tree(test_tree);
+ENDTEST
+
+TEST(test_tree_avl_delete, "Delete from an AVL tree (A, B, C, H, U)")
+bst_init(&test_tree);
+for (int i = 0; i < sorted_data_count; i++) {
+  bst_avl_insert(&test_tree, sorted_keys[i],
+                 create_integer_content(base_values[i]));
+}
+bst_avl_delete(&test_tree, 'A');
+bst_avl_delete(&test_tree, 'B');
+bst_avl_delete(&test_tree, 'C');
+bst_avl_delete(&test_tree, 'H');
+bst_avl_delete(&test_tree, 'U');
+bst_print_tree(test_tree);
+bst_node_content_t* result = NULL;
+bst_search(test_tree, 'G', &result);
+bst_print_search_result(result);
+ENDTEST
+
+TEST(test_tree_traverse_deep, "Traverse a degenerate tree with 90 levels")
+bst_init(&test_tree);
+for (int i = 89; i >= 0; i--) {
+  bst_insert(&test_tree, (char)(' ' + i), create_integer_content(i));
+}
+bst_preorder(test_tree, test_items);
+bst_print_items_summary(test_items);
+bst_reset_items(test_items);
+bst_inorder(test_tree, test_items);
+bst_print_items_summary(test_items);
+bst_reset_items(test_items);
+bst_postorder(test_tree, test_items);
+bst_print_items_summary(test_items);
+ENDTEST
+
+TEST(test_tree_morris_preorder, "Traverse the tree using preorder without a stack")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_insert_many(&test_tree, additional_keys, additional_values,
+                additional_data_count);
+bst_morris_preorder(test_tree, test_items);
+bst_print_items(test_items);
+bst_reset_items(test_items);
+bst_preorder(test_tree, test_items);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_morris_inorder, "Traverse the tree using inorder without a stack")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_insert_many(&test_tree, additional_keys, additional_values,
+                additional_data_count);
+bst_morris_inorder(test_tree, test_items);
+bst_print_tree(test_tree);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_pool, "Insert and delete nodes allocated from a pool")
+bst_pool_t pool;
+bst_pool_init(&pool);
+bst_init(&test_tree);
+for (int i = 0; i < base_data_count; i++) {
+  bst_pool_insert(&pool, &test_tree, base_keys[i],
+                  create_integer_content(base_values[i]));
+}
+bst_pool_insert(&pool, &test_tree, 'H', create_integer_content(1));
+bst_pool_delete(&pool, &test_tree, 'L');
+bst_pool_delete(&pool, &test_tree, 'A');
+bst_pool_delete(&pool, &test_tree, 'U');
+bst_pool_insert(&pool, &test_tree, 'P', create_integer_content(17));
+bst_print_tree(test_tree);
+bst_pool_dispose(&pool, &test_tree);
+bst_print_tree(test_tree);
+ENDTEST
+
+TEST(test_tree_frozen, "Search the keys from @ to [ in a frozen tree")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, additional_keys, additional_values,
+                additional_data_count);
+bst_insert_many(&test_tree, traversal_keys, traversal_values,
+                traversal_data_count);
+bst_frozen_t frozen;
+bst_freeze(test_tree, &frozen);
+int found = 0;
+for (char key = '@'; key <= '['; key++) {
+  bst_node_content_t* result = NULL;
+  if (bst_frozen_search(&frozen, key, &result)) {
+    printf("%c: ", key);
+    bst_print_node_content(result);
+    printf("\n");
+    found++;
+  }
+}
+printf("Found %d of %d nodes\n", found, frozen.count);
+bst_frozen_dispose(&frozen);
+bst_freeze(NULL, &frozen);
+printf("Empty frozen tree: %d nodes\n", frozen.count);
+bst_frozen_dispose(&frozen);
+ENDTEST
+
+// Returns the i-th of the letters A-Z a-z in a scrambled order
+char bplus_test_key(int i) {
+  int letter = i * 19 % 52;
+  return letter < 26 ? 'A' + letter : 'a' + letter - 26;
+}
+
+TEST(test_bplus_insert, "Insert the letters A-Z a-z into a B+ tree")
+bst_init(&test_tree);
+bplus_node_t *bplus_tree;
+bplus_init(&bplus_tree);
+for (int i = 0; i < 52; i++) {
+  bplus_insert(&bplus_tree, bplus_test_key(i), create_integer_content(i));
+}
+bplus_insert(&bplus_tree, 'q', create_integer_content(100));
+bplus_items_t bplus_items = {.nodes = NULL, .capacity = 0, .size = 0};
+bplus_preorder(bplus_tree, &bplus_items);
+bplus_print_items(&bplus_items);
+bplus_items.size = 0;
+bplus_inorder(bplus_tree, &bplus_items);
+bplus_print_items(&bplus_items);
+bplus_items.size = 0;
+bplus_postorder(bplus_tree, &bplus_items);
+bplus_print_items(&bplus_items);
+free(bplus_items.nodes);
+bst_node_content_t* result = NULL;
+bplus_search(bplus_tree, 'q', &result);
+bst_print_search_result(result);
+result = NULL;
+bplus_search(bplus_tree, '#', &result);
+bst_print_search_result(result);
+bplus_dispose(&bplus_tree);
+ENDTEST
+
+TEST(test_bplus_delete, "Delete the letters A-Z and then a-z from a B+ tree")
+bst_init(&test_tree);
+bplus_node_t *bplus_tree;
+bplus_init(&bplus_tree);
+for (int i = 0; i < 52; i++) {
+  bplus_insert(&bplus_tree, bplus_test_key(i), create_integer_content(i));
+}
+for (char key = 'A'; key <= 'Z'; key++) {
+  bplus_delete(&bplus_tree, key);
+}
+bplus_delete(&bplus_tree, '#');
+bplus_items_t bplus_items = {.nodes = NULL, .capacity = 0, .size = 0};
+bplus_preorder(bplus_tree, &bplus_items);
+bplus_print_items(&bplus_items);
+bst_node_content_t* result = NULL;
+bplus_search(bplus_tree, 'z', &result);
+bst_print_search_result(result);
+for (char key = 'a'; key <= 'z'; key++) {
+  bplus_delete(&bplus_tree, key);
+}
+bplus_items.size = 0;
+bplus_preorder(bplus_tree, &bplus_items);
+bplus_print_items(&bplus_items);
+free(bplus_items.nodes);
+bplus_dispose(&bplus_tree);
+ENDTEST
+
+TEST(test_keyed_i64, "Insert, search and delete 64-bit keys")
+bst_init(&test_tree);
+const int64_t i64_keys[] = {INT64_C(5000000000), -7, INT64_MAX, 300,
+                            INT64_MIN, INT64_C(5000000001)};
+bst_i64_node_t *i64_tree;
+bst_i64_init(&i64_tree);
+for (int i = 0; i < 6; i++) {
+  bst_i64_insert(&i64_tree, i64_keys[i], create_integer_content(i + 1));
+}
+bst_i64_insert(&i64_tree, 300, create_integer_content(40));
+bst_i64_delete(&i64_tree, INT64_C(5000000000));
+bst_i64_delete(&i64_tree, 301);
+for (int i = 0; i < 6; i++) {
+  bst_node_content_t* result = NULL;
+  bst_i64_search(i64_tree, i64_keys[i], &result);
+  printf("%lld: ", (long long)i64_keys[i]);
+  bst_print_node_content(result);
+  printf("\n");
+}
+bst_i64_dispose(&i64_tree);
+printf("Disposed tree: %s\n", i64_tree == NULL ? "NULL" : "not NULL");
+ENDTEST
+
+TEST(test_keyed_str, "Insert, search and delete string keys")
+bst_init(&test_tree);
+const char *str_keys[] = {"kiwi", "apple", "orange", "banana", "cherry"};
+char buffer[16];
+bst_str_node_t *str_tree;
+bst_str_init(&str_tree);
+for (int i = 0; i < 5; i++) {
+  // The tree copies the keys, the buffer is overwritten right away
+  strcpy(buffer, str_keys[i]);
+  bst_str_insert(&str_tree, buffer, create_integer_content(i + 1));
+}
+strcpy(buffer, "unused");
+bst_str_insert(&str_tree, "apple", create_integer_content(20));
+bst_str_delete(&str_tree, "kiwi");
+bst_str_delete(&str_tree, "grape");
+for (int i = 0; i < 5; i++) {
+  bst_node_content_t* result = NULL;
+  bst_str_search(str_tree, str_keys[i], &result);
+  printf("%s: ", str_keys[i]);
+  bst_print_node_content(result);
+  printf("\n");
+}
+bst_str_dispose(&str_tree);
+ENDTEST
+
+TEST(test_tree_range, "Collect the nodes with keys from C to J, X to Z and J to C")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_range(test_tree, 'C', 'J', test_items);
+bst_print_items(test_items);
+bst_reset_items(test_items);
+bst_range(test_tree, 'X', 'Z', test_items);
+bst_print_items(test_items);
+bst_reset_items(test_items);
+bst_range(test_tree, 'J', 'C', test_items);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_cursor, "Walk from the lower bound of K forward and from G back")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+for (bst_node_t *node = bst_lower_bound(test_tree, 'K'); node != NULL;
+     node = bst_next(test_tree, node)) {
+  bst_add_node_to_items(node, test_items);
+}
+bst_print_items(test_items);
+bst_reset_items(test_items);
+for (bst_node_t *node = bst_lower_bound(test_tree, 'G'); node != NULL;
+     node = bst_prev(test_tree, node)) {
+  bst_add_node_to_items(node, test_items);
+}
+bst_print_items(test_items);
+printf("Lower bound of @: ");
+bst_print_node(bst_lower_bound(test_tree, '@'));
+printf("\nLower bound of P: %s\n",
+       bst_lower_bound(test_tree, 'P') == NULL ? "NULL" : "not NULL");
+ENDTEST
+
+// Adds the nodes of the tree in the order to the items one by one
+void iterate_to_items(bst_node_t *tree, bst_order_t order, bst_items_t *items) {
+  bst_iterator_t iterator;
+  bst_iterator_init(&iterator, tree, order);
+  for (bst_node_t *node = bst_iterator_next(&iterator); node != NULL;
+       node = bst_iterator_next(&iterator)) {
+    bst_add_node_to_items(node, items);
+  }
+  bst_iterator_done(&iterator);
+}
+
+TEST(test_tree_iterator, "Iterate the tree in preorder, inorder and postorder")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_insert_many(&test_tree, additional_keys, additional_values,
+                additional_data_count);
+iterate_to_items(test_tree, BST_PREORDER, test_items);
+bst_print_items(test_items);
+bst_reset_items(test_items);
+iterate_to_items(test_tree, BST_INORDER, test_items);
+bst_print_items(test_items);
+bst_reset_items(test_items);
+iterate_to_items(test_tree, BST_POSTORDER, test_items);
+bst_print_items(test_items);
+bst_reset_items(test_items);
+iterate_to_items(NULL, BST_INORDER, test_items);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_iterator_deep, "Iterate a degenerate tree with 90 levels")
+bst_init(&test_tree);
+for (int i = 89; i >= 0; i--) {
+  bst_insert(&test_tree, (char)(' ' + i), create_integer_content(i));
+}
+iterate_to_items(test_tree, BST_POSTORDER, test_items);
+bst_print_items_summary(test_items);
+bst_reset_items(test_items);
+
+// Stops after the first three nodes
+bst_iterator_t iterator;
+bst_iterator_init(&iterator, test_tree, BST_INORDER);
+for (int i = 0; i < 3; i++) {
+  bst_add_node_to_items(bst_iterator_next(&iterator), test_items);
+}
+bst_iterator_done(&iterator);
+bst_print_items(test_items);
+ENDTEST
+
+// Fills the keys and contents of the first count letters from A on
+void build_letters(int keys[], bst_node_content_t contents[], int count) {
+  for (int i = 0; i < count; i++) {
+    keys[i] = 'A' + i;
+    contents[i] = create_integer_content(i + 1);
+  }
+}
+
+TEST(test_tree_build, "Build trees from 15 and 6 sorted keys")
+int keys[15];
+bst_node_content_t contents[15];
+build_letters(keys, contents, 15);
+bst_build(&test_tree, keys, contents, 15);
+bst_print_tree(test_tree);
+bst_dispose(&test_tree);
+build_letters(keys, contents, 6);
+bst_build(&test_tree, keys, contents, 6);
+bst_avl_insert(&test_tree, 'G', create_integer_content(7));
+bst_print_tree(test_tree);
+ENDTEST
+
+TEST(test_tree_build_parallel, "Build a tree from 26 sorted keys in 4 threads")
+int keys[26];
+bst_node_content_t contents[26];
+build_letters(keys, contents, 26);
+bst_build_parallel(&test_tree, keys, contents, 26, 4);
+bst_inorder(test_tree, test_items);
+bst_print_items(test_items);
+bst_reset_items(test_items);
+bst_preorder(test_tree, test_items);
+bst_print_items(test_items);
+ENDTEST
+
+TEST(test_tree_parallel, "Traverse and dispose the tree in 4 threads")
+bst_init(&test_tree);
+bst_insert_many(&test_tree, base_keys, base_values, base_data_count);
+bst_insert_many(&test_tree, additional_keys, additional_values,
+                additional_data_count);
+bst_insert_many(&test_tree, traversal_keys, traversal_values,
+                traversal_data_count);
+bst_preorder_parallel(test_tree, test_items, 4);
+bst_print_items(test_items);
+bst_reset_items(test_items);
+bst_inorder_parallel(test_tree, test_items, 4);
+bst_print_items(test_items);
+bst_reset_items(test_items);
+bst_postorder_parallel(test_tree, test_items, 4);
+bst_print_items(test_items);
+bst_dispose_parallel(&test_tree, 4);
+bst_print_tree(test_tree);
+ENDTEST
+
+TEST(test_persist_snapshot, "Read an old version while the tree changes")
+bst_init(&test_tree);
+bst_persist_t persist_tree;
+bst_persist_init(&persist_tree);
+for (int i = 0; i < base_data_count; i++) {
+  bst_persist_insert(&persist_tree, base_keys[i],
+                     create_integer_content(base_values[i]));
+}
+const bst_persist_node_t *version = bst_persist_read_begin(&persist_tree, 0);
+bst_persist_delete(&persist_tree, 'H');
+bst_persist_delete(&persist_tree, 'A');
+bst_persist_delete(&persist_tree, 'U');
+bst_persist_insert(&persist_tree, 'D', create_integer_content(40));
+bst_persist_insert(&persist_tree, 'P', create_integer_content(17));
+bst_persist_print(version);
+const bst_node_content_t *persist_result = NULL;
+bst_persist_search(version, 'D', &persist_result);
+bst_print_search_result((bst_node_content_t *)persist_result);
+bst_persist_read_end(&persist_tree, 0);
+version = bst_persist_read_begin(&persist_tree, 1);
+bst_persist_print(version);
+printf("Root: %c\n", version->key);
+bst_persist_read_end(&persist_tree, 1);
+bst_persist_dispose(&persist_tree);
+ENDTEST
+
+// Inserts and deletes the keys of one thread of test_concurrent_tree
+typedef struct concurrent_test_thread {
+  bst_concurrent_t *tree;
+  int index;
+  pthread_t thread;
+} concurrent_test_thread_t;
+
+static void *concurrent_test_worker(void *argument) {
+  concurrent_test_thread_t *thread = argument;
+  for (int i = thread->index; i < additional_data_count; i += 4) {
+    bst_concurrent_insert(thread->tree, additional_keys[i],
+                          create_integer_content(additional_values[i]));
+  }
+  for (int i = thread->index; i < 8; i += 4) {
+    bst_concurrent_delete(thread->tree, base_keys[i]);
+  }
+  return NULL;
+}
+
+TEST(test_concurrent_tree, "Insert and delete keys in 4 threads at once")
+bst_init(&test_tree);
+bst_concurrent_t concurrent_tree;
+bst_concurrent_init(&concurrent_tree);
+for (int i = 0; i < base_data_count; i++) {
+  bst_concurrent_insert(&concurrent_tree, base_keys[i],
+                        create_integer_content(base_values[i]));
+}
+concurrent_test_thread_t threads[4];
+for (int i = 0; i < 4; i++) {
+  threads[i].tree = &concurrent_tree;
+  threads[i].index = i;
+  pthread_create(&threads[i].thread, NULL, concurrent_test_worker,
+                 &threads[i]);
+}
+for (int i = 0; i < 4; i++) {
+  pthread_join(threads[i].thread, NULL);
+}
+bst_concurrent_print(&concurrent_tree);
+bst_node_content_t concurrent_result;
+bst_concurrent_search(&concurrent_tree, 'K', &concurrent_result);
+bst_print_search_result(&concurrent_result);
+bst_concurrent_dispose(&concurrent_tree);
+ENDTEST
+
 #ifdef EXA
 
 TEST(test_letter_count, "Count letters");
@@ -182,6 +635,20 @@ letter_count(&test_tree, "abBcCc_ 123 *");
 bst_print_tree(test_tree);
 ENDTEST
 
+TEST(test_letter_count_long, "Count letters in a text of several chunks");
+bst_init(&test_tree);
+const char sentence[] = "The quick brown fox jumps over the lazy dog, 42x! ";
+int sentence_length = (int)strlen(sentence);
+char *text = malloc(200 * sentence_length + 1);
+for (int i = 0; i < 200; i++) {
+  memcpy(&text[i * sentence_length], sentence, sentence_length);
+}
+text[200 * sentence_length] = '\0';
+letter_count(&test_tree, text);
+bst_print_tree(test_tree);
+free(text);
+ENDTEST
+
 #endif // EXA
 
 int main(int argc, char *argv[]) {
@@ -210,4 +677,32 @@ int main(int argc, char *argv[]) {
 #ifdef EXA
   test_letter_count();
 #endif // EXA
+
+  test_tree_balance_empty();
+  test_tree_balance_degenerate();
+  test_tree_balance_partial();
+  test_tree_avl_insert_sorted();
+  test_tree_avl_delete();
+  test_tree_traverse_deep();
+  test_tree_morris_preorder();
+  test_tree_morris_inorder();
+  test_tree_pool();
+  test_tree_frozen();
+  test_bplus_insert();
+  test_bplus_delete();
+  test_keyed_i64();
+  test_keyed_str();
+  test_tree_range();
+  test_tree_cursor();
+  test_tree_iterator();
+  test_tree_iterator_deep();
+  test_tree_build();
+  test_tree_build_parallel();
+  test_tree_parallel();
+  test_persist_snapshot();
+  test_concurrent_tree();
+
+#ifdef EXA
+  test_letter_count_long();
+#endif // EXA
 }
@@ -71,6 +71,17 @@ void bst_print_items(bst_items_t *items) {
   printf("\n");
 }
 
+void bst_print_items_summary(bst_items_t *items) {
+  printf("Traversed items: %d", items->size);
+  if (items->size > 0) {
+    printf(", first ");
+    bst_print_node(items->nodes[0]);
+    printf(", last ");
+    bst_print_node(items->nodes[items->size - 1]);
+  }
+  printf("\n");
+}
+
 void bst_print_search_result(bst_node_content_t* content)
 {
   printf("Search result: ");
@@ -84,6 +95,7 @@ void bst_reset_items (bst_items_t *items) {
     {
       free(items->nodes);
     }
+    items->nodes = NULL;
     items->capacity = 0;
     items->size = 0;
   }
@@ -106,3 +118,51 @@ void bst_insert_many(bst_node_t **tree, const char keys[], const int values[],
     bst_insert(tree, keys[i], create_integer_content(values[i]));
   }
 }
+
+void bplus_print_items(bplus_items_t *items) {
+  printf("Traversed nodes:\n");
+  for (int i = 0; i < items->size; i++) {
+    printf("[");
+    for (int j = 0; j < items->nodes[i]->count; j++) {
+      printf(j > 0 ? " %c" : "%c", items->nodes[i]->keys[j]);
+    }
+    printf("]");
+  }
+  printf("\n");
+}
+
+// Prints the nodes of the version in key order
+static void bst_persist_print_nodes(const bst_persist_node_t *tree) {
+  if (tree == NULL) {
+    return;
+  }
+  bst_persist_print_nodes(tree->left);
+  printf("[%c,", tree->key);
+  bst_print_node_content((bst_node_content_t *)&tree->content);
+  printf("]");
+  bst_persist_print_nodes(tree->right);
+}
+
+void bst_persist_print(const bst_persist_node_t *tree) {
+  printf("Version items:\n");
+  bst_persist_print_nodes(tree);
+  printf("\n");
+}
+
+// Prints the nodes of the subtree in key order
+static void bst_concurrent_print_nodes(bst_concurrent_node_t *tree) {
+  if (tree == NULL) {
+    return;
+  }
+  bst_concurrent_print_nodes(tree->left);
+  printf("[%c,", tree->key);
+  bst_print_node_content(&tree->content);
+  printf("]");
+  bst_concurrent_print_nodes(tree->right);
+}
+
+void bst_concurrent_print(bst_concurrent_t *tree) {
+  printf("Concurrent tree items:\n");
+  bst_concurrent_print_nodes(tree->root);
+  printf("\n");
+}
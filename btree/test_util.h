@@ -2,6 +2,13 @@
 #define IAL_BTREE_TEST_UTIL_H
 
 #include "btree.h"
+#include "pool.h"
+#include "frozen.h"
+#include "bplus.h"
+#include "keyed.h"
+#include "iterator.h"
+#include "persist.h"
+#include "concurrent.h"
 #include <stdio.h>
 
 #define TEST(NAME, DESCRIPTION)                                                \
@@ -27,5 +34,9 @@ void bst_insert_many(bst_node_t **tree, const char keys[], const int values[],
                      int count);
 bst_items_t* bst_init_items();
 void bst_print_items(bst_items_t *items);
+void bst_print_items_summary(bst_items_t *items);
 void bst_reset_items (bst_items_t *items);
+void bplus_print_items(bplus_items_t *items);
+void bst_persist_print(const bst_persist_node_t *tree);
+void bst_concurrent_print(bst_concurrent_t *tree);
 #endif
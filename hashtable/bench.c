@@ -0,0 +1,638 @@
+/*
+ * Výkonnostní testy tabulky s rozptýlenými položkami.
+ *
+ * Pro každou sadu klíčů a každou rozptylovací funkci vypíše rozložení délek
+ * seznamů synonym a průměrnou dobu jednoho vyhledání. Dále porovná
+ * propustnost jednotlivých implementací tabulky na velké sadě klíčů, start
+ * ze snímku a škálování tabulky pro více vláken.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "concurrent.h"
+#include "hash.h"
+#include "hashtable.h"
+#include "map.h"
+#include "snapshot.h"
+#include "swiss.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_KEYS 2000
+#define BENCH_ROUNDS 20
+#define BENCH_KEY_SIZE 24
+#define BENCH_MAP_KEYS 50000
+#define BENCH_BATCH 256
+#define BENCH_CONCURRENT_KEYS 10000
+#define BENCH_CONCURRENT_READS 200000
+
+// Number of histogram ranges: 0, 1, 2-3, 4-7, ..., 64+
+#define BENCH_HISTOGRAM 8
+
+typedef struct bench_corpus {
+    const char *name;
+    char **keys;
+    int count;
+} bench_corpus_t;
+
+static uint64_t bench_state = 0x2545F4914F6CDD1DULL;
+
+// Deterministic xorshift generator so that every run uses the same keys
+static uint32_t bench_random(void) {
+    bench_state ^= bench_state << 13;
+    bench_state ^= bench_state >> 7;
+    bench_state ^= bench_state << 17;
+    return (uint32_t)(bench_state >> 32);
+}
+
+// Returns monotonic-enough wall clock time in nanoseconds
+static double bench_now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Allocates storage for count keys of at most BENCH_KEY_SIZE bytes
+static void bench_corpus_alloc(bench_corpus_t *corpus, const char *name,
+                               int count) {
+    corpus->name = name;
+    corpus->count = count;
+    corpus->keys = malloc(count * sizeof(char *));
+    for (int i = 0; i < count; i++) {
+        corpus->keys[i] = malloc(BENCH_KEY_SIZE);
+    }
+}
+
+static void bench_corpus_free(bench_corpus_t *corpus) {
+    for (int i = 0; i < corpus->count; i++) {
+        free(corpus->keys[i]);
+    }
+    free(corpus->keys);
+}
+
+// Random 3 to 5 letter exchange tickers ("XRP", "DOGE", ...)
+static void bench_corpus_tickers(bench_corpus_t *corpus, int count) {
+    bench_corpus_alloc(corpus, "tickers", count);
+    for (int i = 0; i < corpus->count; i++) {
+        int length = 3 + bench_random() % 3;
+        for (int j = 0; j < length; j++) {
+            corpus->keys[i][j] = 'A' + bench_random() % 26;
+        }
+        corpus->keys[i][length] = '\0';
+    }
+}
+
+// Coin names glued from common prefixes and suffixes ("Litecoin 12", ...)
+static void bench_corpus_names(bench_corpus_t *corpus, int count) {
+    static const char *prefixes[] = {"Bit", "Eth", "Lite", "Doge", "Sol",
+                                     "Poly", "Chain", "Uni", "Ava", "Car"};
+    static const char *suffixes[] = {"coin", "ereum", "swap", "link", "ana",
+                                     "dano", "lanche", "dot", "cash", "token"};
+
+    bench_corpus_alloc(corpus, "names", count);
+    for (int i = 0; i < corpus->count; i++) {
+        snprintf(corpus->keys[i], BENCH_KEY_SIZE, "%s%s %d", prefixes[i % 10],
+                 suffixes[(i / 10) % 10], i / 100);
+    }
+}
+
+// Permutations of the same letters, all of them collide in the sum hash
+static void bench_corpus_anagrams(bench_corpus_t *corpus, int count) {
+    const char *base = "TERRACOIN";
+    int length = strlen(base);
+
+    bench_corpus_alloc(corpus, "anagrams", count);
+    for (int i = 0; i < corpus->count; i++) {
+        strcpy(corpus->keys[i], base);
+        for (int j = length - 1; j > 0; j--) {
+            int k = bench_random() % (j + 1);
+            char swap = corpus->keys[i][j];
+            corpus->keys[i][j] = corpus->keys[i][k];
+            corpus->keys[i][k] = swap;
+        }
+    }
+}
+
+// Sequential order identifiers ("order-000123")
+static void bench_corpus_ids(bench_corpus_t *corpus, int count) {
+    bench_corpus_alloc(corpus, "ids", count);
+    for (int i = 0; i < corpus->count; i++) {
+        snprintf(corpus->keys[i], BENCH_KEY_SIZE, "order-%06d", i);
+    }
+}
+
+// Returns the index of the histogram range for the given chain length
+static int bench_histogram_index(int length) {
+    int index = 0;
+    while (length > 0 && index < BENCH_HISTOGRAM - 1) {
+        length >>= 1;
+        index++;
+    }
+    return index;
+}
+
+static void bench_print_header(void) {
+    printf("%-10s %-6s %6s %6s  %-41s %10s\n", "corpus", "hash", "empty",
+           "max", "chains 0/1/2+/4+/8+/16+/32+/64+", "ns/lookup");
+}
+
+// Inserts the corpus into the legacy table and measures the lookups
+static void bench_legacy(bench_corpus_t *corpus, ht_hash_id_t hash) {
+    ht_table_t *table = malloc(sizeof(ht_table_t));
+    ht_hash_function = ht_hash_by_id(hash);
+    HT_SIZE = MAX_HT_SIZE;
+    ht_init(table);
+
+    for (int i = 0; i < corpus->count; i++) {
+        ht_insert(table, corpus->keys[i], (float)i);
+    }
+
+    // Collects the chain length distribution
+    int histogram[BENCH_HISTOGRAM] = {0};
+    int max = 0;
+    for (int i = 0; i < HT_SIZE; i++) {
+        int length = 0;
+        for (ht_item_t *item = (*table)[i]; item != NULL; item = item->next) {
+            length++;
+        }
+        histogram[bench_histogram_index(length)]++;
+        if (length > max) {
+            max = length;
+        }
+    }
+
+    // Measures the average lookup time
+    float sum = 0;
+    double start = bench_now();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int i = 0; i < corpus->count; i++) {
+            sum += *ht_get(table, corpus->keys[i]);
+        }
+    }
+    double elapsed = bench_now() - start;
+
+    char chains[64];
+    int written = 0;
+    for (int i = 0; i < BENCH_HISTOGRAM; i++) {
+        written += snprintf(chains + written, sizeof(chains) - written,
+                            i == 0 ? "%d" : "/%d", histogram[i]);
+    }
+    printf("%-10s %-6s %6d %6d  %-41s %10.1f\n", corpus->name,
+           ht_hash_name(hash), histogram[0], max, chains,
+           elapsed / ((double)BENCH_ROUNDS * corpus->count));
+
+    // Keeps the compiler from optimizing the lookups away
+    if (sum < 0) {
+        printf("%f\n", sum);
+    }
+
+    ht_delete_all(table);
+    free(table);
+}
+
+// Operations of one table backend used by the throughput comparison
+typedef struct bench_backend {
+    const char *name;
+    void *(*create)(void);
+    void (*insert)(void *table, char *key, float value);
+    float *(*get)(void *table, char *key);
+    void (*clear)(void *table);
+    void (*destroy)(void *table);
+} bench_backend_t;
+
+static void *bench_fixed_create(void) {
+    ht_table_t *table = malloc(sizeof(ht_table_t));
+    HT_SIZE = MAX_HT_SIZE;
+    ht_init(table);
+    return table;
+}
+
+static void bench_fixed_insert(void *table, char *key, float value) {
+    ht_insert(table, key, value);
+}
+
+static float *bench_fixed_get(void *table, char *key) {
+    return ht_get(table, key);
+}
+
+static void bench_fixed_clear(void *table) {
+    ht_delete_all(table);
+}
+
+static void bench_fixed_destroy(void *table) {
+    ht_delete_all(table);
+    free(table);
+}
+
+static void *bench_map_create(void) {
+    ht_map_t *map = malloc(sizeof(ht_map_t));
+    ht_map_init(map);
+    return map;
+}
+
+static void *bench_owned_create(void) {
+    ht_map_t *map = malloc(sizeof(ht_map_t));
+    ht_map_init_owned(map);
+    return map;
+}
+
+static void bench_map_insert(void *map, char *key, float value) {
+    ht_map_insert(map, key, value);
+}
+
+static float *bench_map_get(void *map, char *key) {
+    return ht_map_get(map, key);
+}
+
+static void bench_map_clear(void *map) {
+    ht_map_delete_all(map);
+}
+
+static void bench_map_destroy(void *map) {
+    ht_map_dispose(map);
+    free(map);
+}
+
+static void *bench_swiss_create(void) {
+    ht_swiss_t *table = malloc(sizeof(ht_swiss_t));
+    ht_swiss_init(table);
+    return table;
+}
+
+static void bench_swiss_insert(void *table, char *key, float value) {
+    ht_swiss_insert(table, key, value);
+}
+
+static float *bench_swiss_get(void *table, char *key) {
+    return ht_swiss_get(table, key);
+}
+
+static void bench_swiss_clear(void *table) {
+    ht_swiss_delete_all(table);
+}
+
+static void bench_swiss_destroy(void *table) {
+    ht_swiss_dispose(table);
+    free(table);
+}
+
+static const bench_backend_t bench_backends[] = {
+    {"fixed", bench_fixed_create, bench_fixed_insert, bench_fixed_get,
+     bench_fixed_clear, bench_fixed_destroy},
+    {"chained", bench_map_create, bench_map_insert, bench_map_get,
+     bench_map_clear, bench_map_destroy},
+    {"owned", bench_owned_create, bench_map_insert, bench_map_get,
+     bench_map_clear, bench_map_destroy},
+    {"swiss", bench_swiss_create, bench_swiss_insert, bench_swiss_get,
+     bench_swiss_clear, bench_swiss_destroy},
+};
+
+// Measures inserts, successful and failed lookups of one backend
+static void bench_backend(const bench_backend_t *backend,
+                          bench_corpus_t *corpus, bench_corpus_t *missing) {
+    void *table = backend->create();
+
+    // Inserts the corpus and tracks the slowest single insert
+    double worst = 0;
+    double start = bench_now();
+    for (int i = 0; i < corpus->count; i++) {
+        double single = bench_now();
+        backend->insert(table, corpus->keys[i], (float)i);
+        single = bench_now() - single;
+        if (single > worst) {
+            worst = single;
+        }
+    }
+    double insert = bench_now() - start;
+
+    float sum = 0;
+    start = bench_now();
+    for (int i = 0; i < corpus->count; i++) {
+        sum += *backend->get(table, corpus->keys[i]);
+    }
+    double hit = bench_now() - start;
+
+    int found = 0;
+    start = bench_now();
+    for (int i = 0; i < missing->count; i++) {
+        found += backend->get(table, missing->keys[i]) != NULL;
+    }
+    double miss = bench_now() - start;
+
+    start = bench_now();
+    backend->clear(table);
+    double clear = bench_now() - start;
+
+    printf("%-10s %12.1f %12.1f %12.1f %16.0f %10.1f\n", backend->name,
+           insert / corpus->count, hit / corpus->count, miss / missing->count,
+           worst, clear / 1000);
+
+    // Keeps the compiler from optimizing the lookups away
+    if (sum < 0 || found != 0) {
+        printf("%f %d\n", sum, found);
+    }
+
+    backend->destroy(table);
+}
+
+// Compares single and batched lookups in the resizable table
+static void bench_batch(bench_corpus_t *corpus, size_t size) {
+    ht_map_config_t config = {.size = size};
+    ht_map_t map;
+    ht_map_init_config(&map, &config);
+    for (int i = 0; i < corpus->count; i++) {
+        ht_map_insert(&map, corpus->keys[i], (float)i);
+    }
+
+    // Looks the keys up in a random order so that the chains are not cached
+    char **keys = malloc(corpus->count * sizeof(char *));
+    float **values = malloc(BENCH_BATCH * sizeof(float *));
+    for (int i = 0; i < corpus->count; i++) {
+        keys[i] = corpus->keys[bench_random() % corpus->count];
+    }
+
+    float sum = 0;
+    double start = bench_now();
+    for (int i = 0; i < corpus->count; i++) {
+        sum += *ht_map_get(&map, keys[i]);
+    }
+    double single = bench_now() - start;
+
+    start = bench_now();
+    for (int i = 0; i < corpus->count; i += BENCH_BATCH) {
+        int count = corpus->count - i < BENCH_BATCH ? corpus->count - i
+                                                    : BENCH_BATCH;
+        ht_map_get_many(&map, &keys[i], count, values);
+        for (int j = 0; j < count; j++) {
+            sum += *values[j];
+        }
+    }
+    double batch = bench_now() - start;
+
+    printf("%-10d %12.1f %12.1f\n", corpus->count, single / corpus->count,
+           batch / corpus->count);
+
+    // Keeps the compiler from optimizing the lookups away
+    if (sum < 0) {
+        printf("%f\n", sum);
+    }
+
+    free(keys);
+    free(values);
+    ht_map_dispose(&map);
+}
+
+// Compares rebuilding the table by inserts with opening its snapshot
+static void bench_snapshot(bench_corpus_t *corpus) {
+    const char *path = "bench_snapshot.ht";
+
+    double start = bench_now();
+    ht_map_t map;
+    ht_map_init(&map);
+    for (int i = 0; i < corpus->count; i++) {
+        ht_map_insert(&map, corpus->keys[i], (float)i);
+    }
+    double rebuild = bench_now() - start;
+
+    start = bench_now();
+    bool written = ht_snapshot_write(&map, path);
+    double write = bench_now() - start;
+    ht_map_dispose(&map);
+
+    ht_snapshot_t snapshot;
+    start = bench_now();
+    bool opened = written && ht_snapshot_open(&snapshot, path);
+    double open = bench_now() - start;
+    if (!opened) {
+        printf("%-10d snapshot failed\n", corpus->count);
+        remove(path);
+        return;
+    }
+
+    // The first lookups pay for the page faults of the mapping
+    float sum = 0;
+    start = bench_now();
+    for (int i = 0; i < corpus->count; i++) {
+        sum += *ht_snapshot_get(&snapshot, corpus->keys[i]);
+    }
+    double lookup = bench_now() - start;
+
+    printf("%-10d %12.2f %12.2f %12.3f %12.1f\n", corpus->count,
+           rebuild / 1e6, write / 1e6, open / 1e6, lookup / corpus->count);
+
+    // Keeps the compiler from optimizing the lookups away
+    if (sum < 0) {
+        printf("%f\n", sum);
+    }
+
+    ht_snapshot_close(&snapshot);
+    remove(path);
+}
+
+// State of one thread of the concurrent benchmark
+typedef struct bench_worker {
+    pthread_t thread;
+    bench_corpus_t *corpus;
+    ht_concurrent_t *table;  // lock-free readers, NULL for the global lock
+    ht_map_t *map;           // table behind the global lock
+    pthread_mutex_t *lock;   // the global lock
+    atomic_bool *stop;       // tells the writer to finish
+    uint64_t state;          // private random generator state
+    long operations;         // finished operations
+    long errors;             // values that did not belong to their key
+} bench_worker_t;
+
+static uint32_t bench_worker_random(bench_worker_t *worker) {
+    worker->state ^= worker->state << 13;
+    worker->state ^= worker->state >> 7;
+    worker->state ^= worker->state << 17;
+    return (uint32_t)(worker->state >> 32);
+}
+
+// Reads random keys, the value of key i has to be i whenever it is found
+static void *bench_reader(void *argument) {
+    bench_worker_t *worker = argument;
+    for (long i = 0; i < BENCH_CONCURRENT_READS; i++) {
+        int index = bench_worker_random(worker) % worker->corpus->count;
+        char *key = worker->corpus->keys[index];
+        float value = (float)index;
+        bool found;
+
+        if (worker->table != NULL) {
+            found = ht_concurrent_get(worker->table, key, &value);
+        } else {
+            pthread_mutex_lock(worker->lock);
+            float *result = ht_map_get(worker->map, key);
+            found = result != NULL;
+            if (found) {
+                value = *result;
+            }
+            pthread_mutex_unlock(worker->lock);
+        }
+
+        if (found && value != (float)index) {
+            worker->errors++;
+        }
+        worker->operations++;
+    }
+
+    ht_concurrent_thread_exit();
+    return NULL;
+}
+
+// Keeps deleting and inserting random keys until the readers finish
+static void *bench_writer(void *argument) {
+    bench_worker_t *worker = argument;
+    while (!atomic_load(worker->stop)) {
+        int index = bench_worker_random(worker) % worker->corpus->count;
+        char *key = worker->corpus->keys[index];
+
+        if (worker->table != NULL) {
+            ht_concurrent_delete(worker->table, key);
+            ht_concurrent_insert(worker->table, key, (float)index);
+        } else {
+            pthread_mutex_lock(worker->lock);
+            ht_map_delete(worker->map, key);
+            ht_map_insert(worker->map, key, (float)index);
+            pthread_mutex_unlock(worker->lock);
+        }
+        worker->operations++;
+    }
+    return NULL;
+}
+
+// Runs the given number of readers next to one writer
+static void bench_concurrent_run(bench_corpus_t *corpus, int readers,
+                                 bool lock_free) {
+    ht_concurrent_t table;
+    ht_map_t map;
+    pthread_mutex_t lock;
+    atomic_bool stop;
+
+    ht_concurrent_init(&table, corpus->count);
+    ht_map_init(&map);
+    pthread_mutex_init(&lock, NULL);
+    atomic_init(&stop, false);
+    for (int i = 0; i < corpus->count; i++) {
+        ht_concurrent_insert(&table, corpus->keys[i], (float)i);
+        ht_map_insert(&map, corpus->keys[i], (float)i);
+    }
+
+    bench_worker_t workers[readers + 1];
+    for (int i = 0; i <= readers; i++) {
+        workers[i] = (bench_worker_t){.corpus = corpus,
+                                      .table = lock_free ? &table : NULL,
+                                      .map = &map,
+                                      .lock = &lock,
+                                      .stop = &stop,
+                                      .state = 0x9E3779B97F4A7C15ULL * (i + 1),
+                                      .operations = 0,
+                                      .errors = 0};
+    }
+
+    double start = bench_now();
+    pthread_create(&workers[readers].thread, NULL, bench_writer,
+                   &workers[readers]);
+    for (int i = 0; i < readers; i++) {
+        pthread_create(&workers[i].thread, NULL, bench_reader, &workers[i]);
+    }
+
+    long reads = 0;
+    long errors = 0;
+    for (int i = 0; i < readers; i++) {
+        pthread_join(workers[i].thread, NULL);
+        reads += workers[i].operations;
+        errors += workers[i].errors;
+    }
+    double elapsed = bench_now() - start;
+    atomic_store(&stop, true);
+    pthread_join(workers[readers].thread, NULL);
+
+    printf("%-12s %8d %14.2f %14.2f %8ld\n",
+           lock_free ? "striped" : "global lock", readers,
+           reads / elapsed * 1000, workers[readers].operations / elapsed * 1000,
+           errors);
+
+    ht_concurrent_dispose(&table);
+    ht_map_dispose(&map);
+    pthread_mutex_destroy(&lock);
+}
+
+int main(int argc, char *argv[]) {
+    bench_corpus_t corpora[4];
+    bench_corpus_tickers(&corpora[0], BENCH_KEYS);
+    bench_corpus_names(&corpora[1], BENCH_KEYS);
+    bench_corpus_anagrams(&corpora[2], BENCH_KEYS);
+    bench_corpus_ids(&corpora[3], BENCH_KEYS);
+
+    printf("Hash functions - %d keys, %d buckets\n", BENCH_KEYS, MAX_HT_SIZE);
+    bench_print_header();
+    for (int i = 0; i < 4; i++) {
+        for (int hash = 0; hash < HT_HASH_COUNT; hash++) {
+            bench_legacy(&corpora[i], hash);
+        }
+    }
+
+    for (int i = 0; i < 4; i++) {
+        bench_corpus_free(&corpora[i]);
+    }
+
+    bench_corpus_t large;
+    bench_corpus_t missing;
+    bench_corpus_ids(&large, BENCH_MAP_KEYS);
+    bench_corpus_tickers(&missing, BENCH_MAP_KEYS);
+    ht_hash_function = ht_hash_mix64;
+
+    printf("\nTable backends - %d keys\n", BENCH_MAP_KEYS);
+    printf("%-10s %12s %12s %12s %16s %10s\n", "backend", "ns/insert",
+           "ns/hit", "ns/miss", "worst insert ns", "clear us");
+    for (int i = 0; i < sizeof(bench_backends) / sizeof(bench_backends[0]);
+         i++) {
+        bench_backend(&bench_backends[i], &large, &missing);
+    }
+
+    bench_corpus_free(&large);
+    bench_corpus_free(&missing);
+
+    printf("\nBatched lookups - %d keys per batch\n", BENCH_BATCH);
+    printf("%-10s %12s %12s\n", "keys", "ns/get", "ns/get_many");
+    for (int count = BENCH_MAP_KEYS / 10; count <= BENCH_MAP_KEYS * 20;
+         count *= 10) {
+        bench_corpus_t batch;
+        bench_corpus_ids(&batch, count);
+        bench_batch(&batch, (size_t)count);
+        bench_corpus_free(&batch);
+    }
+
+    printf("\nSnapshot - rebuild by inserts vs open of the mapped file\n");
+    printf("%-10s %12s %12s %12s %12s\n", "keys", "rebuild ms", "write ms",
+           "open ms", "ns/first get");
+    for (int count = BENCH_MAP_KEYS / 10; count <= BENCH_MAP_KEYS * 20;
+         count *= 10) {
+        bench_corpus_t keys;
+        bench_corpus_ids(&keys, count);
+        bench_snapshot(&keys);
+        bench_corpus_free(&keys);
+    }
+
+    // Doubles the readers up to twice the number of processors
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_readers = processors > 2 ? (int)processors * 2 : 4;
+    bench_corpus_t shared;
+    bench_corpus_ids(&shared, BENCH_CONCURRENT_KEYS);
+
+    printf("\nConcurrent table - %d keys, %d reads per reader, 1 writer, "
+           "%ld processors\n",
+           BENCH_CONCURRENT_KEYS, BENCH_CONCURRENT_READS, processors);
+    printf("%-12s %8s %14s %14s %8s\n", "table", "readers", "Mreads/s",
+           "Mwrites/s", "errors");
+    for (int readers = 1; readers <= max_readers; readers *= 2) {
+        bench_concurrent_run(&shared, readers, false);
+        bench_concurrent_run(&shared, readers, true);
+    }
+    bench_corpus_free(&shared);
+    return 0;
+}
@@ -0,0 +1,394 @@
+/*
+ * Tabulka s rozptýlenými položkami pro více vláken
+ *
+ * Seznamy synonym jsou zřetězené atomickými ukazateli. Zapisující vlákno
+ * zamkne pruh seznamů, do kterého patří index klíče, a změny zveřejní
+ * atomickým zápisem ukazatele, takže čtecí vlákno vždy vidí buď starý, nebo
+ * nový stav seznamu.
+ *
+ * Čtecí vlákno si před průchodem seznamem zapíše aktuální epochu do svého
+ * slotu. Odstraněný prvek dostane číslo epochy, ve které byl odstraněn, a
+ * uvolní se až ve chvíli, kdy všechna aktivní čtecí vlákna vstoupila do
+ * novější epochy.
+ */
+
+#include "concurrent.h"
+#include "hash.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Global epoch counter, starts at 1 because 0 marks an inactive reader
+static _Atomic uint64_t ht_epoch = 1;
+
+// Epoch announced by every reader slot, 0 when the reader is outside
+static _Atomic uint64_t ht_reader_epochs[HT_CONCURRENT_READERS];
+
+// Slots claimed by reader threads
+static atomic_bool ht_reader_used[HT_CONCURRENT_READERS];
+
+// Slot of the current thread, -1 until the first read
+static _Thread_local int ht_reader_slot = -1;
+
+// Returns the slot of the current thread, claims one on the first call
+static int ht_reader_claim(void) {
+    if (ht_reader_slot >= 0) {
+        return ht_reader_slot;
+    }
+
+    for (int i = 0; i < HT_CONCURRENT_READERS; i++) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&ht_reader_used[i], &expected,
+                                           true)) {
+            ht_reader_slot = i;
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Announces the current epoch, returns the slot or -1 if there is none left
+static int ht_reader_enter(void) {
+    int slot = ht_reader_claim();
+    if (slot >= 0) {
+        atomic_store(&ht_reader_epochs[slot], atomic_load(&ht_epoch));
+    }
+    return slot;
+}
+
+// Leaves the read-side critical section
+static void ht_reader_exit(int slot) {
+    atomic_store(&ht_reader_epochs[slot], 0);
+}
+
+// Returns the oldest epoch announced by an active reader
+static uint64_t ht_reader_oldest(void) {
+    uint64_t oldest = UINT64_MAX;
+    for (int i = 0; i < HT_CONCURRENT_READERS; i++) {
+        uint64_t epoch = atomic_load(&ht_reader_epochs[i]);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+    return oldest;
+}
+
+// Returns the lock guarding the bucket of the hash
+static pthread_mutex_t *ht_concurrent_stripe(ht_concurrent_t *table,
+                                             uint64_t hash) {
+    size_t index = (size_t)(hash & (table->size - 1));
+    return &table->stripes[index & (HT_CONCURRENT_STRIPES - 1)];
+}
+
+// Returns the bucket of the hash
+static _Atomic(ht_concurrent_item_t *) *
+ht_concurrent_bucket(ht_concurrent_t *table, uint64_t hash) {
+    return &table->buckets[hash & (table->size - 1)];
+}
+
+// Walks the chain without locking
+static ht_concurrent_item_t *ht_concurrent_find(ht_concurrent_t *table,
+                                                char *key, uint64_t hash,
+                                                size_t length) {
+    ht_concurrent_item_t *item = atomic_load(ht_concurrent_bucket(table, hash));
+    while (item != NULL) {
+        if (item->hash == hash && item->length == length &&
+            memcmp(item->key, key, length) == 0) {
+            return item;
+        }
+        item = atomic_load(&item->next);
+    }
+    return NULL;
+}
+
+/*
+ * Předání odstraněných prvků k pozdějšímu uvolnění.
+ *
+ * Prvky dostanou číslo aktuální epochy a epocha se posune. Jakmile čeká
+ * alespoň HT_CONCURRENT_RECLAIM prvků, uvolní se ty, které už žádné čtecí
+ * vlákno nemůže držet.
+ */
+static void ht_concurrent_retire(ht_concurrent_t *table,
+                                 ht_concurrent_item_t *first,
+                                 ht_concurrent_item_t *last) {
+    pthread_mutex_lock(&table->retire_lock);
+
+    if (first != NULL) {
+        uint64_t epoch = atomic_fetch_add(&ht_epoch, 1);
+        for (ht_concurrent_item_t *item = first; item != NULL;
+             item = item->retired_next) {
+            item->retired = epoch;
+            table->retired_count++;
+        }
+        last->retired_next = table->retired;
+        table->retired = first;
+    }
+
+    // Scans the readers only once enough items are waiting
+    if (table->retired_count < HT_CONCURRENT_RECLAIM) {
+        pthread_mutex_unlock(&table->retire_lock);
+        return;
+    }
+
+    // Frees the items retired before the oldest active reader entered
+    uint64_t oldest = ht_reader_oldest();
+    ht_concurrent_item_t **link = &table->retired;
+    while (*link != NULL) {
+        ht_concurrent_item_t *item = *link;
+        if (item->retired < oldest) {
+            *link = item->retired_next;
+            table->retired_count--;
+            free(item);
+        } else {
+            link = &item->retired_next;
+        }
+    }
+
+    pthread_mutex_unlock(&table->retire_lock);
+}
+
+/*
+ * Inicializace tabulky se zadaným počtem seznamů synonym.
+ *
+ * Počet se zaokrouhlí nahoru na mocninu dvou a během života tabulky se
+ * nemění. Tabulka si uloží aktuální rozptylovací funkci s nulovým semínkem,
+ * jiné semínko lze nastavit do hasher.seed před prvním vložením. Vrací
+ * false, pokud se nepodařilo alokovat pole.
+ */
+bool ht_concurrent_init(ht_concurrent_t *table, size_t size) {
+    // Checks if pointer to table is valid
+    if (table == NULL) {
+        return false;
+    }
+
+    table->size = 1;
+    while (table->size < size) {
+        table->size *= 2;
+    }
+
+    table->buckets = malloc(table->size * sizeof(*table->buckets));
+    if (table->buckets == NULL) {
+        table->size = 0;
+        return false;
+    }
+    for (size_t i = 0; i < table->size; i++) {
+        atomic_init(&table->buckets[i], NULL);
+    }
+
+    for (int i = 0; i < HT_CONCURRENT_STRIPES; i++) {
+        pthread_mutex_init(&table->stripes[i], NULL);
+    }
+    pthread_mutex_init(&table->retire_lock, NULL);
+    atomic_init(&table->count, 0);
+    table->retired = NULL;
+    table->retired_count = 0;
+    table->hasher = ht_hasher_default();
+    return true;
+}
+
+/*
+ * Zjištění, zda je klíč v tabulce. Funkce nezamyká.
+ */
+bool ht_concurrent_search(ht_concurrent_t *table, char *key) {
+    float value;
+    return ht_concurrent_get(table, key, &value);
+}
+
+/*
+ * Získání hodnoty z tabulky.
+ *
+ * V případě úspěchu zapíše hodnotu prvku do value a vrací true. Hodnota se
+ * kopíruje, protože prvek může být mezitím smazán jiným vláknem.
+ * Funkce nezamyká (pokud vláken není víc než HT_CONCURRENT_READERS).
+ */
+bool ht_concurrent_get(ht_concurrent_t *table, char *key, float *value) {
+    // Checks if pointers to table, key and value are valid
+    if (table == NULL || key == NULL || value == NULL ||
+        table->buckets == NULL) {
+        return false;
+    }
+
+    size_t length;
+    uint64_t hash = ht_hasher_hash(&table->hasher, key, &length);
+
+    // Falls back to the stripe lock when all the reader slots are taken
+    int slot = ht_reader_enter();
+    if (slot < 0) {
+        pthread_mutex_lock(ht_concurrent_stripe(table, hash));
+    }
+
+    ht_concurrent_item_t *item = ht_concurrent_find(table, key, hash, length);
+    if (item != NULL) {
+        *value = atomic_load(&item->value);
+    }
+
+    if (slot < 0) {
+        pthread_mutex_unlock(ht_concurrent_stripe(table, hash));
+    } else {
+        ht_reader_exit(slot);
+    }
+    return item != NULL;
+}
+
+/*
+ * Vložení nového prvku do tabulky.
+ *
+ * Pokud prvek s daným klíčem už v tabulce existuje, nahradí se jeho hodnota.
+ * Tabulka si klíč zkopíruje.
+ */
+void ht_concurrent_insert(ht_concurrent_t *table, char *key, float value) {
+    // Checks if pointers to table and key are valid
+    if (table == NULL || key == NULL || table->buckets == NULL) {
+        return;
+    }
+
+    size_t length;
+    uint64_t hash = ht_hasher_hash(&table->hasher, key, &length);
+    pthread_mutex_t *stripe = ht_concurrent_stripe(table, hash);
+    pthread_mutex_lock(stripe);
+
+    // Checks if the key exists, if so, updates its value
+    ht_concurrent_item_t *item = ht_concurrent_find(table, key, hash, length);
+    if (item != NULL) {
+        atomic_store(&item->value, value);
+        pthread_mutex_unlock(stripe);
+        return;
+    }
+
+    item = malloc(sizeof(ht_concurrent_item_t) + length + 1);
+    if (item == NULL) {
+        pthread_mutex_unlock(stripe);
+        return;
+    }
+    _Atomic(ht_concurrent_item_t *) *bucket = ht_concurrent_bucket(table, hash);
+    memcpy(item->key, key, length + 1);
+    item->hash = hash;
+    item->length = length;
+    item->retired = 0;
+    item->retired_next = NULL;
+    atomic_init(&item->value, value);
+    atomic_init(&item->next, atomic_load(bucket));
+
+    // Publishes the fully initialized item at the head of the chain
+    atomic_store(bucket, item);
+    atomic_fetch_add(&table->count, 1);
+    pthread_mutex_unlock(stripe);
+}
+
+/*
+ * Smazání prvku z tabulky.
+ *
+ * Prvek se odpojí ze seznamu synonym a uvolní se, až ho žádné čtecí vlákno
+ * nemůže držet. Pokud prvek neexistuje, funkce nedělá nic.
+ */
+void ht_concurrent_delete(ht_concurrent_t *table, char *key) {
+    // Checks if pointers to table and key are valid
+    if (table == NULL || key == NULL || table->buckets == NULL) {
+        return;
+    }
+
+    size_t length;
+    uint64_t hash = ht_hasher_hash(&table->hasher, key, &length);
+    pthread_mutex_t *stripe = ht_concurrent_stripe(table, hash);
+    pthread_mutex_lock(stripe);
+
+    // Walks the chain keeping the link pointing to the current item
+    _Atomic(ht_concurrent_item_t *) *link = ht_concurrent_bucket(table, hash);
+    ht_concurrent_item_t *item = atomic_load(link);
+    while (item != NULL) {
+        if (item->hash == hash && item->length == length &&
+            memcmp(item->key, key, length) == 0) {
+            // Readers standing on the item can still continue to its successor
+            atomic_store(link, atomic_load(&item->next));
+            atomic_fetch_sub(&table->count, 1);
+            break;
+        }
+        link = &item->next;
+        item = atomic_load(link);
+    }
+    pthread_mutex_unlock(stripe);
+
+    if (item != NULL) {
+        ht_concurrent_retire(table, item, item);
+    }
+}
+
+/*
+ * Smazání všech prvků z tabulky.
+ *
+ * Každý seznam synonym se odpojí pod zámkem svého pruhu, prvky se uvolní
+ * stejně jako při ht_concurrent_delete.
+ */
+void ht_concurrent_delete_all(ht_concurrent_t *table) {
+    // Checks if pointer to table is valid
+    if (table == NULL || table->buckets == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; i < table->size; i++) {
+        pthread_mutex_t *stripe =
+            &table->stripes[i & (HT_CONCURRENT_STRIPES - 1)];
+        pthread_mutex_lock(stripe);
+        ht_concurrent_item_t *first = atomic_exchange(&table->buckets[i], NULL);
+
+        // Chains the detached items through retired_next
+        ht_concurrent_item_t *last = first;
+        size_t count = 0;
+        for (ht_concurrent_item_t *item = first; item != NULL;
+             item = atomic_load(&item->next)) {
+            item->retired_next = atomic_load(&item->next);
+            last = item;
+            count++;
+        }
+        atomic_fetch_sub(&table->count, count);
+        pthread_mutex_unlock(stripe);
+
+        if (first != NULL) {
+            ht_concurrent_retire(table, first, last);
+        }
+    }
+}
+
+/*
+ * Zrušení tabulky.
+ *
+ * Žádné jiné vlákno už nesmí s tabulkou pracovat.
+ */
+void ht_concurrent_dispose(ht_concurrent_t *table) {
+    if (table == NULL || table->buckets == NULL) {
+        return;
+    }
+
+    ht_concurrent_delete_all(table);
+
+    // Frees the rest of the retired items regardless of the readers
+    while (table->retired != NULL) {
+        ht_concurrent_item_t *item = table->retired;
+        table->retired = item->retired_next;
+        free(item);
+    }
+    table->retired_count = 0;
+
+    for (int i = 0; i < HT_CONCURRENT_STRIPES; i++) {
+        pthread_mutex_destroy(&table->stripes[i]);
+    }
+    pthread_mutex_destroy(&table->retire_lock);
+    free(table->buckets);
+    table->buckets = NULL;
+    table->size = 0;
+}
+
+/*
+ * Uvolnění slotu čtecího vlákna.
+ *
+ * Vlákno, které četlo z tabulky, by tuto funkci mělo zavolat před svým
+ * ukončením, jinak jeho slot zůstane obsazený.
+ */
+void ht_concurrent_thread_exit(void) {
+    if (ht_reader_slot < 0) {
+        return;
+    }
+
+    atomic_store(&ht_reader_epochs[ht_reader_slot], 0);
+    atomic_store(&ht_reader_used[ht_reader_slot], false);
+    ht_reader_slot = -1;
+}
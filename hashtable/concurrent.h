@@ -0,0 +1,60 @@
+/*
+ * Hlavičkový soubor pro tabulku s rozptýlenými položkami pro více vláken.
+ *
+ * Zapisující vlákna zamykají jen skupinu (pruh) seznamů synonym, do které
+ * klíč patří. Čtecí operace nezamykají nic; smazané položky se uvolňují až
+ * ve chvíli, kdy je žádné čtecí vlákno nemůže držet (epochy).
+ */
+
+#ifndef IAL_HASHTABLE_CONCURRENT_H
+#define IAL_HASHTABLE_CONCURRENT_H
+
+#include "hash.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Počet zámků, mezi které se rozdělí seznamy synonym
+#define HT_CONCURRENT_STRIPES 64
+
+// Maximální počet současně registrovaných čtecích vláken
+#define HT_CONCURRENT_READERS 128
+
+// Počet odstraněných prvků, po kterém se zkusí uvolnit
+#define HT_CONCURRENT_RECLAIM 64
+
+// Prvek tabulky
+typedef struct ht_concurrent_item {
+  _Atomic(struct ht_concurrent_item *) next; // další synonymum
+  _Atomic float value;                       // hodnota prvku
+  uint64_t hash;                             // úplný hash klíče
+  size_t length;                             // délka klíče
+  uint64_t retired;                          // epocha odstranění z tabulky
+  struct ht_concurrent_item *retired_next;   // další odstraněný prvek
+  char key[];                                // kopie klíče
+} ht_concurrent_item_t;
+
+// Tabulka pevné velikosti pro více vláken
+typedef struct ht_concurrent {
+  _Atomic(ht_concurrent_item_t *) *buckets;       // pole seznamů synonym
+  size_t size;                                    // velikost pole
+  atomic_size_t count;                            // počet položek
+  pthread_mutex_t stripes[HT_CONCURRENT_STRIPES]; // zámky pruhů
+  pthread_mutex_t retire_lock;                    // zámek seznamu retired
+  ht_concurrent_item_t *retired;                  // prvky čekající na uvolnění
+  size_t retired_count;                           // počet prvků v retired
+  ht_hasher_t hasher;                             // rozptylovací funkce
+} ht_concurrent_t;
+
+bool ht_concurrent_init(ht_concurrent_t *table, size_t size);
+bool ht_concurrent_search(ht_concurrent_t *table, char *key);
+bool ht_concurrent_get(ht_concurrent_t *table, char *key, float *value);
+void ht_concurrent_insert(ht_concurrent_t *table, char *key, float value);
+void ht_concurrent_delete(ht_concurrent_t *table, char *key);
+void ht_concurrent_delete_all(ht_concurrent_t *table);
+void ht_concurrent_dispose(ht_concurrent_t *table);
+void ht_concurrent_thread_exit(void);
+
+#endif
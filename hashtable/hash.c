@@ -0,0 +1,183 @@
+/*
+ * Rozptylovací funkce pro tabulku s rozptýlenými položkami.
+ *
+ * Všechny funkce procházejí klíč jen jednou a zároveň počítají jeho délku,
+ * takže volající nemusí volat strlen.
+ */
+
+#include "hash.h"
+
+#define HT_PRIME_1 0x9E3779B185EBCA87ULL
+#define HT_PRIME_2 0xC2B2AE3D27D4EB4FULL
+#define HT_PRIME_3 0x165667B19E3779F9ULL
+#define HT_PRIME_4 0x85EBCA77C2B2AE63ULL
+#define HT_PRIME_5 0x27D4EB2F165667C5ULL
+
+#define HT_FNV_OFFSET 0xCBF29CE484222325ULL
+#define HT_FNV_PRIME 0x00000100000001B3ULL
+
+ht_hash_function_t ht_hash_function = ht_hash_mix64;
+
+// Rotates the value to the left by r bits
+static uint64_t ht_rotl(uint64_t value, int r) {
+    return (value << r) | (value >> (64 - r));
+}
+
+// Mixes one 8 byte lane into the accumulator (xxHash64 round)
+static uint64_t ht_mix_lane(uint64_t hash, uint64_t lane) {
+    lane *= HT_PRIME_2;
+    lane = ht_rotl(lane, 31);
+    lane *= HT_PRIME_1;
+    hash ^= lane;
+    return ht_rotl(hash, 27) * HT_PRIME_1 + HT_PRIME_4;
+}
+
+// Final avalanche so that every input bit affects every output bit
+static uint64_t ht_avalanche(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= HT_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HT_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+/*
+ * Původní aditivní rozptylovací funkce (součet bajtů klíče).
+ *
+ * Anagramy a podobné klíče mají stejný otisk, funkce je zachována pro
+ * porovnání a pro testy s referenčním výstupem.
+ */
+uint64_t ht_hash_sum(const char *key, uint64_t seed, size_t *length) {
+    const unsigned char *bytes = (const unsigned char *)key;
+    uint64_t result = 1 + seed;
+    size_t i = 0;
+
+    // Sums the bytes of the key
+    while (bytes[i] != '\0') {
+        result += bytes[i];
+        i++;
+    }
+
+    if (length != NULL) {
+        *length = i;
+    }
+    return result;
+}
+
+/*
+ * Rozptylovací funkce FNV-1a (64 bitů).
+ */
+uint64_t ht_hash_fnv1a(const char *key, uint64_t seed, size_t *length) {
+    const unsigned char *bytes = (const unsigned char *)key;
+    uint64_t hash = HT_FNV_OFFSET ^ seed;
+    size_t i = 0;
+
+    // Xors and multiplies every byte into the hash
+    while (bytes[i] != '\0') {
+        hash ^= bytes[i];
+        hash *= HT_FNV_PRIME;
+        i++;
+    }
+
+    if (length != NULL) {
+        *length = i;
+    }
+    return hash;
+}
+
+/*
+ * Rozptylovací funkce ve stylu xxHash64.
+ *
+ * Bajty klíče se skládají do 64bitových slov, každé slovo se promíchá
+ * násobením a rotací a na konci se přimíchá délka klíče.
+ */
+uint64_t ht_hash_mix64(const char *key, uint64_t seed, size_t *length) {
+    const unsigned char *bytes = (const unsigned char *)key;
+    uint64_t hash = seed + HT_PRIME_5;
+    uint64_t lane = 0;
+    size_t i = 0;
+
+    while (bytes[i] != '\0') {
+        // Collects the byte into the current lane
+        lane |= (uint64_t)bytes[i] << ((i & 7) * 8);
+        i++;
+
+        // Mixes the lane once it is full
+        if ((i & 7) == 0) {
+            hash = ht_mix_lane(hash, lane);
+            lane = 0;
+        }
+    }
+
+    // Mixes the incomplete last lane
+    if ((i & 7) != 0) {
+        hash = ht_mix_lane(hash, lane);
+    }
+
+    if (length != NULL) {
+        *length = i;
+    }
+    return ht_avalanche(hash + (uint64_t)i * HT_PRIME_3);
+}
+
+/*
+ * Vrací dvojici aktuální rozptylovací funkce ht_hash_function a nulového
+ * semínka. Tabulky si ji uloží při inicializaci, pozdější změna
+ * ht_hash_function je tak neovlivní.
+ */
+ht_hasher_t ht_hasher_default(void) {
+    ht_hasher_t hasher = {.function = ht_hash_function, .seed = 0};
+    return hasher;
+}
+
+/*
+ * Vrací otisk klíče podle funkce a semínka tabulky.
+ */
+uint64_t ht_hasher_hash(const ht_hasher_t *hasher, const char *key,
+                        size_t *length) {
+    return hasher->function(key, hasher->seed, length);
+}
+
+/*
+ * Vrací název rozptylovací funkce.
+ */
+const char *ht_hash_name(ht_hash_id_t id) {
+    switch (id) {
+#define X(name)                                                                \
+    case HT_HASH_##name:                                                       \
+        return #name;
+        HT_HASH_FUNCTIONS
+#undef X
+    default:
+        return "unknown";
+    }
+}
+
+/*
+ * Vrací rozptylovací funkci podle jejího identifikátoru, případně NULL.
+ */
+ht_hash_function_t ht_hash_by_id(ht_hash_id_t id) {
+    switch (id) {
+#define X(name)                                                                \
+    case HT_HASH_##name:                                                       \
+        return ht_hash_##name;
+        HT_HASH_FUNCTIONS
+#undef X
+    default:
+        return NULL;
+    }
+}
+
+/*
+ * Vrací identifikátor rozptylovací funkce, pro neznámou funkci HT_HASH_COUNT.
+ */
+ht_hash_id_t ht_hash_id_of(ht_hash_function_t function) {
+#define X(name)                                                                \
+    if (function == ht_hash_##name) {                                          \
+        return HT_HASH_##name;                                                 \
+    }
+    HT_HASH_FUNCTIONS
+#undef X
+    return HT_HASH_COUNT;
+}
@@ -0,0 +1,59 @@
+/*
+ * Hlavičkový soubor pro rozptylovací funkce tabulky.
+ */
+
+#ifndef IAL_HASHTABLE_HASH_H
+#define IAL_HASHTABLE_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Rozptylovací funkce nad řetězcem ukončeným nulou.
+ *
+ * Vrací 64bitový otisk klíče a pokud length není NULL, zapíše do něj délku
+ * klíče. Klíč je procházen pouze jednou (bez předchozího volání strlen).
+ */
+typedef uint64_t (*ht_hash_function_t)(const char *key, uint64_t seed,
+                                        size_t *length);
+
+// Seznam dostupných rozptylovacích funkcí
+#define HT_HASH_FUNCTIONS                                                      \
+  X(sum)                                                                       \
+  X(fnv1a)                                                                     \
+  X(mix64)
+
+#define X(name)                                                                \
+  uint64_t ht_hash_##name(const char *key, uint64_t seed, size_t *length);
+HT_HASH_FUNCTIONS
+#undef X
+
+// Identifikátor rozptylovací funkce
+typedef enum ht_hash_id {
+#define X(name) HT_HASH_##name,
+  HT_HASH_FUNCTIONS
+#undef X
+  HT_HASH_COUNT
+} ht_hash_id_t;
+
+/*
+ * Rozptylovací funkce používaná funkcí get_hash.
+ * Výchozí hodnotou je ht_hash_mix64.
+ */
+extern ht_hash_function_t ht_hash_function;
+
+// Rozptylovací funkce a semínko jedné tabulky
+typedef struct ht_hasher {
+  ht_hash_function_t function; // rozptylovací funkce
+  uint64_t seed;               // semínko
+} ht_hasher_t;
+
+ht_hasher_t ht_hasher_default(void);
+uint64_t ht_hasher_hash(const ht_hasher_t *hasher, const char *key,
+                        size_t *length);
+
+const char *ht_hash_name(ht_hash_id_t id);
+ht_hash_function_t ht_hash_by_id(ht_hash_id_t id);
+ht_hash_id_t ht_hash_id_of(ht_hash_function_t function);
+
+#endif
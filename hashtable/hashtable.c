@@ -9,6 +9,7 @@
  */
 
 #include "hashtable.h"
+#include "hash.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -19,14 +20,9 @@ int HT_SIZE = MAX_HT_SIZE;
  * <0,HT_SIZE-1>. Ideální rozptylovací funkce by měla rozprostírat klíče
  * rovnoměrně po všech indexech. Zamyslete sa nad kvalitou zvolené funkce.
  */
-// Funkce muze generovat stjeny vysledek pro ruzne vstupy a neni moc dobra
+// Index se počítá z 64bitového otisku funkce ht_hash_function (viz hash.h)
 int get_hash(char *key) {
-  int result = 1;
-  int length = strlen(key);
-  for (int i = 0; i < length; i++) {
-    result += key[i];
-  }
-  return (result % HT_SIZE);
+  return (int)(ht_hash_function(key, 0, NULL) % (uint64_t)HT_SIZE);
 }
 
 /*
@@ -44,25 +40,22 @@ void ht_init(ht_table_t *table) {
     }
 }
 
-/*
- * Vyhledání prvku v tabulce.
- *
- * V případě úspěchu vrací ukazatel na nalezený prvek; v opačném případě vrací
- * hodnotu NULL.
- */
-ht_item_t *ht_search(ht_table_t *table, char *key) {
-    // Checks if pointers to table and key are valid
-    if (table == NULL || key == NULL) {
-        return NULL;
-    }
+// Checks if the item holds the key, the string is compared only as a last resort
+static bool ht_item_matches(ht_item_t *item, char *key, uint64_t hash,
+                            size_t length) {
+    return item->hash == hash && item->length == length &&
+           memcmp(item->key, key, length) == 0;
+}
 
+// Searches the chain of the already computed hash for the key
+static ht_item_t *ht_search_hashed(ht_table_t *table, char *key, uint64_t hash,
+                                   size_t length) {
     // Find initial address of an item with the key
-    ht_item_t *item = (*table)[get_hash(key)];
-
+    ht_item_t *item = (*table)[hash % (uint64_t)HT_SIZE];
 
     while (item != NULL) {
         // If the key is found, returns the item
-        if (strcmp(item->key, key) == 0) {
+        if (ht_item_matches(item, key, hash, length)) {
             return item;
         }
 
@@ -74,6 +67,23 @@ ht_item_t *ht_search(ht_table_t *table, char *key) {
     return NULL;
 }
 
+/*
+ * Vyhledání prvku v tabulce.
+ *
+ * V případě úspěchu vrací ukazatel na nalezený prvek; v opačném případě vrací
+ * hodnotu NULL.
+ */
+ht_item_t *ht_search(ht_table_t *table, char *key) {
+    // Checks if pointers to table and key are valid
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+
+    size_t length;
+    uint64_t hash = ht_hash_function(key, 0, &length);
+    return ht_search_hashed(table, key, hash, length);
+}
+
 /*
  * Vložení nového prvku do tabulky.
  *
@@ -88,8 +98,12 @@ void ht_insert(ht_table_t *table, char *key, float value) {
         return;
     }
 
+    // Computes the hash only once for both the search and the insertion
+    size_t length;
+    uint64_t hash = ht_hash_function(key, 0, &length);
+
     // Checks if the key exists, if so, updates its value
-    ht_item_t *res = ht_search(table, key);
+    ht_item_t *res = ht_search_hashed(table, key, hash, length);
     if (res != NULL) {
         res->value = value;
         return;
@@ -97,12 +111,18 @@ void ht_insert(ht_table_t *table, char *key, float value) {
 
     // Creates new item and sets its properties
     ht_item_t *item = malloc(sizeof(ht_item_t));
+    if (item == NULL) {
+        return;
+    }
+    int index = (int)(hash % (uint64_t)HT_SIZE);
     item->key = key;
     item->value = value;
-    item->next = (*table)[get_hash(key)];
+    item->length = length;
+    item->hash = hash;
+    item->next = (*table)[index];
 
     // Inserts the new item into the hash table
-    (*table)[get_hash(key)] = item;
+    (*table)[index] = item;
 }
 
 /*
@@ -143,25 +163,23 @@ void ht_delete(ht_table_t *table, char *key) {
         return;
     }
 
-    // Find initial address of an item with the key
-    ht_item_t *item = (*table)[get_hash(key)];
-    ht_item_t *prevItem;
+    size_t length;
+    uint64_t hash = ht_hash_function(key, 0, &length);
 
-    while (item != NULL) {
-        // If the key is found, break the loop
-        if (strcmp(item->key, key) == 0) {
-            break;
+    // Walks the chain keeping the link pointing to the current item
+    ht_item_t **link = &(*table)[hash % (uint64_t)HT_SIZE];
+    while (*link != NULL) {
+        ht_item_t *item = *link;
+
+        // If the key is found, unlinks and deallocates the item
+        if (ht_item_matches(item, key, hash, length)) {
+            *link = item->next;
+            free(item);
+            return;
         }
 
-        // Sets previous item to the current item and increments the item position
-        prevItem = item;
-        item = item->next;
+        link = &item->next;
     }
-
-    // Sets the next item of the previous item to point to the item after the deleted one
-    prevItem->next = item->next;
-    // Deallocates memory from teh ite,
-    free(item);
 }
 
 /*
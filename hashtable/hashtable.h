@@ -7,6 +7,8 @@
 #define IAL_HASHTABLE_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /*
  * Maximálna veľkosť poľa pre implementáciu tabuľky.
@@ -25,6 +27,8 @@ extern int HT_SIZE;
 typedef struct ht_item {
   char *key;            // kľúč prvku
   float value;          // hodnota prvku
+  size_t length;        // dĺžka kľúča
+  uint64_t hash;        // úplný 64bitový hash kľúča
   struct ht_item *next; // ukazateľ na ďalšie synonymum
 } ht_item_t;
 
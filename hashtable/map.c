@@ -0,0 +1,541 @@
+/*
+ * Tabulka s rozptýlenými položkami s proměnnou velikostí
+ *
+ * Synonyma jsou explicitně zřetězená stejně jako v hashtable.c, velikost
+ * pole je ale mocnina dvou a index se počítá maskou. Při překročení
+ * HT_MAP_MAX_LOAD se alokuje dvojnásobné pole a položky se do něj přesouvají
+ * postupně během následujících operací, takže žádné volání nezaplatí celé
+ * přehašování najednou.
+ */
+
+#include "map.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Hints the processor to load the address into the cache
+#if defined(__GNUC__)
+#define HT_MAP_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define HT_MAP_PREFETCH(address) ((void)(address))
+#endif
+
+// Returns the bucket index of the hash in an array of the given size
+static size_t ht_map_index(uint64_t hash, size_t size) {
+    return (size_t)(hash & (size - 1));
+}
+
+// Checks if the item holds the key, the string is compared only as a last resort
+static bool ht_map_matches(ht_item_t *item, char *key, uint64_t hash,
+                           size_t length) {
+    return item->hash == hash && item->length == length &&
+           memcmp(item->key, key, length) == 0;
+}
+
+// Searches the chain for the key, counts the compared items into probes
+static ht_item_t *ht_map_chain_search(ht_item_t *item, char *key,
+                                      uint64_t hash, size_t length,
+                                      size_t *probes) {
+    while (item != NULL) {
+        (*probes)++;
+        if (ht_map_matches(item, key, hash, length)) {
+            return item;
+        }
+        item = item->next;
+    }
+    return NULL;
+}
+
+// Unlinks the item with the key from the chain, returns the unlinked item
+static ht_item_t *ht_map_chain_unlink(ht_item_t **chain, char *key,
+                                      uint64_t hash, size_t length) {
+    while (*chain != NULL) {
+        if (ht_map_matches(*chain, key, hash, length)) {
+            ht_item_t *item = *chain;
+            *chain = item->next;
+            return item;
+        }
+        chain = &(*chain)->next;
+    }
+    return NULL;
+}
+
+// Returns the chain of the old array that may contain the hash, or NULL
+static ht_item_t **ht_map_old_chain(ht_map_t *map, uint64_t hash) {
+    if (map->old_buckets == NULL) {
+        return NULL;
+    }
+
+    // Chains before rehash_index have already been moved
+    size_t index = ht_map_index(hash, map->old_size);
+    if (index < map->rehash_index) {
+        return NULL;
+    }
+    return &map->old_buckets[index];
+}
+
+/*
+ * Přesune několik seznamů synonym z původního pole do nového.
+ */
+static void ht_map_rehash_step(ht_map_t *map, size_t steps) {
+    if (map->old_buckets == NULL) {
+        return;
+    }
+
+    while (steps > 0 && map->rehash_index < map->old_size) {
+        ht_item_t *item = map->old_buckets[map->rehash_index];
+        map->old_buckets[map->rehash_index] = NULL;
+
+        // Moves every item of the chain to the head of its new chain
+        while (item != NULL) {
+            ht_item_t *next = item->next;
+            size_t index = ht_map_index(item->hash, map->size);
+            item->next = map->buckets[index];
+            map->buckets[index] = item;
+            item = next;
+        }
+
+        map->rehash_index++;
+        steps--;
+    }
+
+    // Releases the old array once everything has been moved
+    if (map->rehash_index == map->old_size) {
+        free(map->old_buckets);
+        map->old_buckets = NULL;
+        map->old_size = 0;
+        map->rehash_index = 0;
+    }
+}
+
+/*
+ * Zahájí zvětšení pole na dvojnásobek.
+ *
+ * Pokud předchozí přesouvání ještě neskončilo, nejdříve ho dokončí. Při
+ * neúspěšné alokaci tabulka dál pracuje s původním polem.
+ */
+static void ht_map_grow(ht_map_t *map) {
+    ht_map_rehash_step(map, map->old_size);
+
+    ht_item_t **buckets = calloc(map->size * 2, sizeof(ht_item_t *));
+    if (buckets == NULL) {
+        return;
+    }
+
+    map->old_buckets = map->buckets;
+    map->old_size = map->size;
+    map->rehash_index = 0;
+    map->buckets = buckets;
+    map->size *= 2;
+    map->stats.resizes++;
+}
+
+// Rounds the size up to a power of two, at least HT_MAP_INITIAL_SIZE for 0
+static size_t ht_map_round_size(size_t size) {
+    if (size == 0) {
+        return HT_MAP_INITIAL_SIZE;
+    }
+
+    size_t result = 1;
+    while (result < size && result <= SIZE_MAX / 2) {
+        result *= 2;
+    }
+    return result;
+}
+
+// Allocates the bucket array and the allocators of the table
+static bool ht_map_setup(ht_map_t *map, const ht_map_config_t *config) {
+    size_t size = ht_map_round_size(config->size);
+    map->buckets = calloc(size, sizeof(ht_item_t *));
+    map->size = map->buckets != NULL ? size : 0;
+    map->old_buckets = NULL;
+    map->old_size = 0;
+    map->rehash_index = 0;
+    map->count = 0;
+    map->owned_keys = config->owned_keys;
+    ht_slab_init(&map->items, config->owned_keys ? sizeof(ht_map_entry_t)
+                                                 : sizeof(ht_item_t));
+    ht_arena_init(&map->keys);
+
+    // Captures the hash function so that later changes of the global one
+    // do not break the table
+    map->hasher = ht_hasher_default();
+    if (config->hash_function != NULL) {
+        map->hasher.function = config->hash_function;
+    }
+    map->hasher.seed = config->seed;
+    memset(&map->stats, 0, sizeof(map->stats));
+    return map->buckets != NULL;
+}
+
+/*
+ * Inicializace tabulky — zavolá se před prvním použitím tabulky.
+ *
+ * Tabulka ukládá ukazatele na klíče volajícího, ten musí zajistit jejich
+ * platnost. Vrací false, pokud se nepodařilo alokovat pole seznamů synonym.
+ */
+bool ht_map_init(ht_map_t *map) {
+    ht_map_config_t config = {0};
+    return ht_map_init_config(map, &config);
+}
+
+/*
+ * Inicializace tabulky, která si ukládá vlastní kopie klíčů.
+ *
+ * Klíče kratší než HT_MAP_INLINE_KEY bajtů se kopírují přímo do položky,
+ * delší do areny tabulky. Paměť dlouhých klíčů smazaných prvků se uvolní až
+ * funkcí ht_map_delete_all.
+ */
+bool ht_map_init_owned(ht_map_t *map) {
+    ht_map_config_t config = {.owned_keys = true};
+    return ht_map_init_config(map, &config);
+}
+
+/*
+ * Inicializace tabulky podle nastavení.
+ *
+ * Počáteční velikost se zaokrouhlí nahoru na mocninu dvou. Bez zadané
+ * rozptylovací funkce se použije aktuální hodnota ht_hash_function; tabulka
+ * si funkci uloží, její pozdější změna ji už neovlivní.
+ */
+bool ht_map_init_config(ht_map_t *map, const ht_map_config_t *config) {
+    // Checks if pointers to map and config are valid
+    if (map == NULL || config == NULL) {
+        return false;
+    }
+    return ht_map_setup(map, config);
+}
+
+// Searches both arrays for the key with the already computed hash
+static ht_item_t *ht_map_lookup(ht_map_t *map, char *key, uint64_t hash,
+                                size_t length) {
+    map->stats.lookups++;
+
+    // Searches the new array first, then the not yet moved old chain
+    ht_item_t *item =
+        ht_map_chain_search(map->buckets[ht_map_index(hash, map->size)], key,
+                            hash, length, &map->stats.probes);
+    if (item == NULL) {
+        ht_item_t **old_chain = ht_map_old_chain(map, hash);
+        if (old_chain != NULL) {
+            item = ht_map_chain_search(*old_chain, key, hash, length,
+                                       &map->stats.probes);
+        }
+    }
+    return item;
+}
+
+// Moves a few chains and searches both arrays for the key
+static ht_item_t *ht_map_find(ht_map_t *map, char *key, uint64_t hash,
+                              size_t length) {
+    ht_map_rehash_step(map, HT_MAP_REHASH_STEP);
+    return ht_map_lookup(map, key, hash, length);
+}
+
+/*
+ * Vyhledání prvku v tabulce.
+ *
+ * V případě úspěchu vrací ukazatel na nalezený prvek; v opačném případě vrací
+ * hodnotu NULL.
+ */
+ht_item_t *ht_map_search(ht_map_t *map, char *key) {
+    // Checks if pointers to map and key are valid
+    if (map == NULL || key == NULL || map->buckets == NULL) {
+        return NULL;
+    }
+
+    size_t length;
+    uint64_t hash = ht_hasher_hash(&map->hasher, key, &length);
+    return ht_map_find(map, key, hash, length);
+}
+
+// Inserts the key with the already computed hash
+static void ht_map_insert_hashed(ht_map_t *map, char *key, uint64_t hash,
+                                 size_t length, float value) {
+    // Checks if the key exists, if so, updates its value
+    ht_item_t *res = ht_map_find(map, key, hash, length);
+    if (res != NULL) {
+        res->value = value;
+        return;
+    }
+
+    // Starts growing the array when the load factor would be exceeded
+    if (map->count + 1 > map->size * HT_MAP_MAX_LOAD) {
+        ht_map_grow(map);
+    }
+
+    // Creates new item and sets its properties
+    ht_item_t *item = ht_slab_alloc(&map->items);
+    if (item == NULL) {
+        return;
+    }
+
+    // Copies the key next to the item or into the arena in owned mode
+    if (map->owned_keys) {
+        if (length < HT_MAP_INLINE_KEY) {
+            ht_map_entry_t *entry = (ht_map_entry_t *)item;
+            memcpy(entry->inline_key, key, length + 1);
+            key = entry->inline_key;
+        } else {
+            key = ht_arena_strdup(&map->keys, key, length);
+            if (key == NULL) {
+                ht_slab_free(&map->items, item);
+                return;
+            }
+        }
+    }
+
+    size_t index = ht_map_index(hash, map->size);
+    item->key = key;
+    item->value = value;
+    item->length = length;
+    item->hash = hash;
+    item->next = map->buckets[index];
+
+    // Inserts the new item into the new array
+    map->buckets[index] = item;
+    map->count++;
+}
+
+/*
+ * Vložení nového prvku do tabulky.
+ *
+ * Pokud prvek s daným klíčem už v tabulce existuje, nahradí se jeho hodnota.
+ * Nový prvek se vkládá na začátek seznamu synonym v novém poli.
+ */
+void ht_map_insert(ht_map_t *map, char *key, float value) {
+    // Checks if pointers to map and key are valid
+    if (map == NULL || key == NULL || map->buckets == NULL) {
+        return;
+    }
+
+    // Computes the hash only once for both the search and the insertion
+    size_t length;
+    uint64_t hash = ht_hasher_hash(&map->hasher, key, &length);
+    ht_map_insert_hashed(map, key, hash, length, value);
+}
+
+/*
+ * Získání hodnoty z tabulky.
+ *
+ * V případě úspěchu vrací funkce ukazatel na hodnotu prvku, v opačném
+ * případě hodnotu NULL.
+ */
+float *ht_map_get(ht_map_t *map, char *key) {
+    ht_item_t *item = ht_map_search(map, key);
+    if (item != NULL) {
+        return &(item->value);
+    }
+    return NULL;
+}
+
+/*
+ * Získání hodnot více klíčů najednou.
+ *
+ * Klíče se zpracovávají po HT_MAP_BATCH: nejdříve se spočítají všechny
+ * otisky a vyžádá se načtení jejich seznamů synonym, teprve potom se
+ * seznamy prohledají, takže čekání na paměť se u jednotlivých klíčů
+ * překrývá. Do values[i] se zapíše totéž, co by vrátila ht_map_get.
+ * Během přesouvání položek do nového pole se klíče hledají po jednom.
+ */
+void ht_map_get_many(ht_map_t *map, char *keys[], size_t count,
+                     float *values[]) {
+    // Checks if pointers to map, keys and values are valid
+    if (map == NULL || keys == NULL || values == NULL) {
+        return;
+    }
+
+    uint64_t hashes[HT_MAP_BATCH];
+    size_t lengths[HT_MAP_BATCH];
+    ht_item_t *heads[HT_MAP_BATCH];
+
+    for (size_t start = 0; start < count; start += HT_MAP_BATCH) {
+        size_t batch =
+            count - start < HT_MAP_BATCH ? count - start : HT_MAP_BATCH;
+        char **batch_keys = &keys[start];
+        float **batch_values = &values[start];
+
+        for (size_t i = 0; i < batch; i++) {
+            batch_values[i] = NULL;
+        }
+        if (map->buckets == NULL) {
+            continue;
+        }
+
+        // Hashes the whole batch and requests the bucket slots
+        ht_map_rehash_step(map, HT_MAP_REHASH_STEP * batch);
+        for (size_t i = 0; i < batch; i++) {
+            if (batch_keys[i] != NULL) {
+                hashes[i] =
+                    ht_hasher_hash(&map->hasher, batch_keys[i], &lengths[i]);
+                HT_MAP_PREFETCH(
+                    &map->buckets[ht_map_index(hashes[i], map->size)]);
+            }
+        }
+
+        // Searches both arrays one key at a time while items are being moved
+        if (map->old_buckets != NULL) {
+            for (size_t i = 0; i < batch; i++) {
+                if (batch_keys[i] == NULL) {
+                    continue;
+                }
+                ht_item_t *item =
+                    ht_map_lookup(map, batch_keys[i], hashes[i], lengths[i]);
+                if (item != NULL) {
+                    batch_values[i] = &item->value;
+                }
+            }
+            continue;
+        }
+
+        // Loads the chain heads and requests their first items
+        for (size_t i = 0; i < batch; i++) {
+            heads[i] = NULL;
+            if (batch_keys[i] != NULL) {
+                heads[i] = map->buckets[ht_map_index(hashes[i], map->size)];
+                if (heads[i] != NULL) {
+                    HT_MAP_PREFETCH(heads[i]);
+                }
+            }
+        }
+
+        // Resolves the keys against the already requested chains
+        for (size_t i = 0; i < batch; i++) {
+            if (batch_keys[i] == NULL) {
+                continue;
+            }
+            map->stats.lookups++;
+            ht_item_t *item =
+                ht_map_chain_search(heads[i], batch_keys[i], hashes[i],
+                                    lengths[i], &map->stats.probes);
+            if (item != NULL) {
+                batch_values[i] = &item->value;
+            }
+        }
+    }
+}
+
+/*
+ * Vložení více prvků najednou.
+ *
+ * Výsledek je stejný jako při postupném volání ht_map_insert, otisky klíčů
+ * se ale počítají po HT_MAP_BATCH a jejich seznamy synonym se načítají
+ * předem.
+ */
+void ht_map_insert_many(ht_map_t *map, char *keys[], const float values[],
+                        size_t count) {
+    // Checks if pointers to map, keys and values are valid
+    if (map == NULL || keys == NULL || values == NULL ||
+        map->buckets == NULL) {
+        return;
+    }
+
+    uint64_t hashes[HT_MAP_BATCH];
+    size_t lengths[HT_MAP_BATCH];
+
+    for (size_t start = 0; start < count; start += HT_MAP_BATCH) {
+        size_t batch =
+            count - start < HT_MAP_BATCH ? count - start : HT_MAP_BATCH;
+
+        // Hashes the whole batch and requests the bucket slots
+        for (size_t i = 0; i < batch; i++) {
+            if (keys[start + i] != NULL) {
+                hashes[i] =
+                    ht_hasher_hash(&map->hasher, keys[start + i], &lengths[i]);
+                HT_MAP_PREFETCH(
+                    &map->buckets[ht_map_index(hashes[i], map->size)]);
+            }
+        }
+
+        for (size_t i = 0; i < batch; i++) {
+            if (keys[start + i] != NULL) {
+                ht_map_insert_hashed(map, keys[start + i], hashes[i],
+                                     lengths[i], values[start + i]);
+            }
+        }
+    }
+}
+
+/*
+ * Smazání prvku z tabulky.
+ *
+ * Pokud prvek neexistuje, funkce nedělá nic.
+ */
+void ht_map_delete(ht_map_t *map, char *key) {
+    // Checks if pointers to map and key are valid
+    if (map == NULL || key == NULL || map->buckets == NULL) {
+        return;
+    }
+
+    ht_map_rehash_step(map, HT_MAP_REHASH_STEP);
+
+    // Unlinks the item from the new array or from the old chain
+    size_t length;
+    uint64_t hash = ht_hasher_hash(&map->hasher, key, &length);
+    ht_item_t *item = ht_map_chain_unlink(
+        &map->buckets[ht_map_index(hash, map->size)], key, hash, length);
+    if (item == NULL) {
+        ht_item_t **old_chain = ht_map_old_chain(map, hash);
+        if (old_chain != NULL) {
+            item = ht_map_chain_unlink(old_chain, key, hash, length);
+        }
+    }
+
+    if (item != NULL) {
+        ht_slab_free(&map->items, item);
+        map->count--;
+    }
+}
+
+/*
+ * Smazání všech prvků z tabulky.
+ *
+ * Položky se uvolní najednou po celých blocích alokátoru, velikost pole
+ * seznamů synonym zůstává zachována.
+ */
+void ht_map_delete_all(ht_map_t *map) {
+    // Checks if pointer to map is valid
+    if (map == NULL || map->buckets == NULL) {
+        return;
+    }
+
+    // Drops the old array, its items are freed together with the rest
+    free(map->old_buckets);
+    map->old_buckets = NULL;
+    map->old_size = 0;
+    map->rehash_index = 0;
+
+    memset(map->buckets, 0, map->size * sizeof(ht_item_t *));
+    ht_slab_release(&map->items);
+    ht_arena_release(&map->keys);
+    map->count = 0;
+}
+
+/*
+ * Zrušení tabulky včetně pole seznamů synonym.
+ *
+ * Před dalším použitím je nutné tabulku znovu inicializovat.
+ */
+void ht_map_dispose(ht_map_t *map) {
+    if (map == NULL) {
+        return;
+    }
+
+    ht_map_delete_all(map);
+    free(map->buckets);
+    map->buckets = NULL;
+    map->size = 0;
+}
+
+/*
+ * Vrací statistiky tabulky.
+ *
+ * Počty vyhledání a porovnaných položek se nenulují funkcí
+ * ht_map_delete_all, jen novou inicializací.
+ */
+ht_map_stats_t ht_map_get_stats(ht_map_t *map) {
+    ht_map_stats_t stats = {0};
+    if (map != NULL) {
+        stats = map->stats;
+    }
+    return stats;
+}
@@ -0,0 +1,92 @@
+/*
+ * Hlavičkový soubor pro tabulku s rozptýlenými položkami s proměnnou
+ * velikostí.
+ *
+ * Na rozdíl od ht_table_t si tabulka sama udržuje velikost pole a při
+ * překročení maximálního zaplnění ho zdvojnásobí. Položky se do nového pole
+ * přesouvají postupně, několik seznamů synonym při každé operaci.
+ * Položky tabulka přiděluje ze svého alokátoru po blocích (viz slab.h).
+ *
+ * Tabulka inicializovaná funkcí ht_map_init_owned si klíče kopíruje. Krátké
+ * klíče se ukládají přímo za položku, delší do areny řetězců tabulky.
+ *
+ * Každá tabulka má vlastní počáteční velikost, rozptylovací funkci se
+ * semínkem a statistiky (viz ht_map_init_config), takže vedle sebe může
+ * existovat více různě nastavených tabulek.
+ */
+
+#ifndef IAL_HASHTABLE_MAP_H
+#define IAL_HASHTABLE_MAP_H
+
+#include "hash.h"
+#include "hashtable.h"
+#include "slab.h"
+#include <stddef.h>
+
+// Počáteční velikost pole (musí být mocninou dvou)
+#define HT_MAP_INITIAL_SIZE 16
+
+// Maximální průměrný počet položek na jeden seznam synonym
+#define HT_MAP_MAX_LOAD 1
+
+// Počet seznamů synonym přesunutých během jedné operace
+#define HT_MAP_REHASH_STEP 4
+
+// Maximální velikost klíče uloženého přímo v položce (včetně nuly)
+#define HT_MAP_INLINE_KEY 16
+
+// Počet klíčů, jejichž seznamy synonym se načítají současně
+#define HT_MAP_BATCH 16
+
+// Položka tabulky s vlastní kopií krátkého klíče
+typedef struct ht_map_entry {
+  ht_item_t item;                     // položka, item.key ukazuje do inline_key
+  char inline_key[HT_MAP_INLINE_KEY]; // kopie krátkého klíče
+} ht_map_entry_t;
+
+// Nastavení tabulky pro ht_map_init_config
+typedef struct ht_map_config {
+  size_t size;                      // počáteční velikost, 0 pro výchozí
+  uint64_t seed;                    // semínko rozptylovací funkce
+  ht_hash_function_t hash_function; // rozptylovací funkce, NULL pro výchozí
+  bool owned_keys;                  // tabulka si ukládá kopie klíčů
+} ht_map_config_t;
+
+// Statistiky tabulky
+typedef struct ht_map_stats {
+  size_t lookups; // počet vyhledání klíče
+  size_t probes;  // počet porovnaných položek při vyhledávání
+  size_t resizes; // počet zvětšení pole
+} ht_map_stats_t;
+
+// Tabulka s proměnnou velikostí
+typedef struct ht_map {
+  ht_item_t **buckets;       // pole seznamů synonym
+  size_t size;               // velikost pole buckets (mocnina dvou)
+  ht_item_t **old_buckets;   // původní pole během přesouvání, jinak NULL
+  size_t old_size;           // velikost pole old_buckets
+  size_t rehash_index;       // první dosud nepřesunutý seznam v old_buckets
+  size_t count;              // počet položek v tabulce
+  ht_slab_allocator_t items; // alokátor položek tabulky
+  bool owned_keys;           // tabulka si ukládá kopie klíčů
+  ht_arena_t keys;           // arena pro kopie dlouhých klíčů
+  ht_hasher_t hasher;        // rozptylovací funkce a semínko tabulky
+  ht_map_stats_t stats;      // statistiky tabulky
+} ht_map_t;
+
+bool ht_map_init(ht_map_t *map);
+bool ht_map_init_owned(ht_map_t *map);
+bool ht_map_init_config(ht_map_t *map, const ht_map_config_t *config);
+ht_item_t *ht_map_search(ht_map_t *map, char *key);
+void ht_map_insert(ht_map_t *map, char *key, float value);
+float *ht_map_get(ht_map_t *map, char *key);
+void ht_map_get_many(ht_map_t *map, char *keys[], size_t count,
+                     float *values[]);
+void ht_map_insert_many(ht_map_t *map, char *keys[], const float values[],
+                        size_t count);
+void ht_map_delete(ht_map_t *map, char *key);
+void ht_map_delete_all(ht_map_t *map);
+void ht_map_dispose(ht_map_t *map);
+ht_map_stats_t ht_map_get_stats(ht_map_t *map);
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * Alokátor položek tabulky po blocích a arena řetězců.
+ */
+
+#include "slab.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Inicializace alokátoru pro položky zadané velikosti.
+ */
+void ht_slab_init(ht_slab_allocator_t *slab, size_t item_size) {
+    // Every item has to be able to hold the free list link
+    if (item_size < sizeof(void *)) {
+        item_size = sizeof(void *);
+    }
+
+    // Rounds the size up so that every item stays pointer aligned
+    slab->item_size =
+        (item_size + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+    slab->slabs = NULL;
+    slab->used = HT_SLAB_ITEMS;
+    slab->free_list = NULL;
+    slab->count = 0;
+}
+
+/*
+ * Přidělení jedné položky.
+ *
+ * Přednostně se použije naposledy uvolněná položka, jinak se posune ukazatel
+ * v nejnovějším bloku. Při neúspěšné alokaci bloku vrací NULL.
+ */
+void *ht_slab_alloc(ht_slab_allocator_t *slab) {
+    // Reuses a released item
+    if (slab->free_list != NULL) {
+        void *item = slab->free_list;
+        slab->free_list = *(void **)item;
+        return item;
+    }
+
+    // Allocates a new block once the newest one is full
+    if (slab->used == HT_SLAB_ITEMS) {
+        ht_slab_t *block =
+            malloc(sizeof(ht_slab_t) + HT_SLAB_ITEMS * slab->item_size);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next = slab->slabs;
+        slab->slabs = block;
+        slab->used = 0;
+        slab->count++;
+    }
+
+    // Bumps the pointer in the newest block
+    void *item = (char *)slab->slabs->items + slab->used * slab->item_size;
+    slab->used++;
+    return item;
+}
+
+/*
+ * Vrácení položky do seznamu volných položek.
+ */
+void ht_slab_free(ht_slab_allocator_t *slab, void *item) {
+    if (item == NULL) {
+        return;
+    }
+
+    *(void **)item = slab->free_list;
+    slab->free_list = item;
+}
+
+/*
+ * Uvolnění všech bloků najednou.
+ *
+ * Složitost odpovídá počtu bloků, ne počtu položek. Alokátor lze dále
+ * používat.
+ */
+void ht_slab_release(ht_slab_allocator_t *slab) {
+    ht_slab_t *block = slab->slabs;
+    while (block != NULL) {
+        ht_slab_t *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    slab->slabs = NULL;
+    slab->used = HT_SLAB_ITEMS;
+    slab->free_list = NULL;
+    slab->count = 0;
+}
+
+/*
+ * Inicializace prázdné areny řetězců.
+ */
+void ht_arena_init(ht_arena_t *arena) {
+    arena->blocks = NULL;
+    arena->used = 0;
+    arena->size = 0;
+}
+
+/*
+ * Uložení kopie řetězce zadané délky do areny.
+ *
+ * Vrací ukazatel na kopii ukončenou nulou, při neúspěšné alokaci NULL.
+ * Kopie zůstává platná do uvolnění celé areny.
+ */
+char *ht_arena_strdup(ht_arena_t *arena, const char *string, size_t length) {
+    // Allocates a new block when the string does not fit into the newest one
+    if (arena->blocks == NULL || arena->size - arena->used < length + 1) {
+        size_t size = length + 1 > HT_ARENA_BLOCK ? length + 1 : HT_ARENA_BLOCK;
+        ht_slab_t *block = malloc(sizeof(ht_slab_t) + size);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next = arena->blocks;
+        arena->blocks = block;
+        arena->used = 0;
+        arena->size = size;
+    }
+
+    // Bumps the pointer and copies the string including the terminator
+    char *copy = (char *)arena->blocks->items + arena->used;
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+    arena->used += length + 1;
+    return copy;
+}
+
+/*
+ * Uvolnění všech bloků areny najednou.
+ */
+void ht_arena_release(ht_arena_t *arena) {
+    ht_slab_t *block = arena->blocks;
+    while (block != NULL) {
+        ht_slab_t *next = block->next;
+        free(block);
+        block = next;
+    }
+    ht_arena_init(arena);
+}
@@ -0,0 +1,54 @@
+/*
+ * Hlavičkový soubor pro alokátor položek tabulky.
+ *
+ * Položky stejné velikosti se přidělují z větších bloků (slabů) posunem
+ * ukazatele, uvolněné položky se řetězí do seznamu volných položek a
+ * znovu se použijí. Všechny bloky se uvolní najednou.
+ *
+ * Pro řetězce proměnné délky slouží jednodušší arena bez uvolňování
+ * jednotlivých řetězců.
+ */
+
+#ifndef IAL_HASHTABLE_SLAB_H
+#define IAL_HASHTABLE_SLAB_H
+
+#include <stddef.h>
+
+// Počet položek v jednom bloku
+#define HT_SLAB_ITEMS 256
+
+// Velikost jednoho bloku areny řetězců
+#define HT_ARENA_BLOCK 4096
+
+// Blok položek
+typedef struct ht_slab {
+  struct ht_slab *next; // další (starší) blok
+  max_align_t items[];  // paměť položek
+} ht_slab_t;
+
+// Alokátor položek jedné velikosti
+typedef struct ht_slab_allocator {
+  ht_slab_t *slabs; // seznam bloků, nejnovější první
+  size_t item_size; // velikost položky zarovnaná na velikost ukazatele
+  size_t used;      // počet použitých položek v nejnovějším bloku
+  void *free_list;  // seznam uvolněných položek
+  size_t count;     // počet bloků
+} ht_slab_allocator_t;
+
+// Arena řetězců
+typedef struct ht_arena {
+  ht_slab_t *blocks; // seznam bloků, nejnovější první
+  size_t used;       // počet použitých bajtů v nejnovějším bloku
+  size_t size;       // velikost nejnovějšího bloku
+} ht_arena_t;
+
+void ht_slab_init(ht_slab_allocator_t *slab, size_t item_size);
+void *ht_slab_alloc(ht_slab_allocator_t *slab);
+void ht_slab_free(ht_slab_allocator_t *slab, void *item);
+void ht_slab_release(ht_slab_allocator_t *slab);
+
+void ht_arena_init(ht_arena_t *arena);
+char *ht_arena_strdup(ht_arena_t *arena, const char *string, size_t length);
+void ht_arena_release(ht_arena_t *arena);
+
+#endif
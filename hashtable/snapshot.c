@@ -0,0 +1,291 @@
+/*
+ * Snímek tabulky s proměnnou velikostí v souboru
+ *
+ * Položky jednoho seznamu synonym leží ve snímku za sebou, seznam i je
+ * určen rozsahem buckets[i] až buckets[i + 1]. Vyhledání tak načte jeden
+ * začátek seznamu a pak prochází souvislé pole místo ukazatelů.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "snapshot.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Returns the bucket index of the hash in a snapshot with the given size
+static size_t ht_snapshot_index(uint64_t hash, uint64_t size) {
+    return (size_t)(hash & (size - 1));
+}
+
+// Counts the items of the chain into their snapshot buckets
+static void ht_snapshot_count(ht_item_t *item, uint64_t *buckets,
+                              uint64_t size, uint64_t *strings_size) {
+    while (item != NULL) {
+        buckets[ht_snapshot_index(item->hash, size) + 1]++;
+        *strings_size += item->length + 1;
+        item = item->next;
+    }
+}
+
+// Copies the items of the chain to the next free slots of their buckets
+static void ht_snapshot_fill(ht_item_t *item, uint64_t *next, uint64_t size,
+                             ht_snapshot_entry_t *entries, char *strings,
+                             uint64_t *strings_used) {
+    while (item != NULL) {
+        ht_snapshot_entry_t *entry =
+            &entries[next[ht_snapshot_index(item->hash, size)]++];
+        entry->hash = item->hash;
+        entry->key_offset = *strings_used;
+        entry->length = (uint32_t)item->length;
+        entry->value = item->value;
+        memcpy(strings + *strings_used, item->key, item->length + 1);
+        *strings_used += item->length + 1;
+        item = item->next;
+    }
+}
+
+// Writes the prepared parts of the snapshot into the file
+static bool ht_snapshot_write_file(const char *path,
+                                   const ht_snapshot_header_t *header,
+                                   const uint64_t *buckets,
+                                   const ht_snapshot_entry_t *entries,
+                                   const char *strings) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    size_t bucket_count = (size_t)header->bucket_count + 1;
+    size_t item_count = (size_t)header->item_count;
+    size_t strings_size = (size_t)header->strings_size;
+    bool result =
+        fwrite(header, sizeof(*header), 1, file) == 1 &&
+        fwrite(buckets, sizeof(uint64_t), bucket_count, file) ==
+            bucket_count &&
+        fwrite(entries, sizeof(ht_snapshot_entry_t), item_count, file) ==
+            item_count &&
+        fwrite(strings, 1, strings_size, file) == strings_size;
+    if (fclose(file) != 0) {
+        result = false;
+    }
+    return result;
+}
+
+// Lays the items out by buckets and writes the snapshot
+static bool ht_snapshot_build(ht_map_t *map, const char *path,
+                              ht_snapshot_header_t *header, uint64_t *buckets,
+                              uint64_t *next, ht_snapshot_entry_t *entries) {
+    // Counts the items of every bucket, then turns the counts into offsets
+    for (size_t i = 0; i < map->size; i++) {
+        ht_snapshot_count(map->buckets[i], buckets, map->size,
+                          &header->strings_size);
+    }
+    for (size_t i = map->rehash_index; i < map->old_size; i++) {
+        ht_snapshot_count(map->old_buckets[i], buckets, map->size,
+                          &header->strings_size);
+    }
+    for (size_t i = 0; i < map->size; i++) {
+        buckets[i + 1] += buckets[i];
+        next[i] = buckets[i];
+    }
+
+    char *strings = malloc(header->strings_size > 0 ? header->strings_size : 1);
+    if (strings == NULL) {
+        return false;
+    }
+
+    uint64_t strings_used = 0;
+    for (size_t i = 0; i < map->size; i++) {
+        ht_snapshot_fill(map->buckets[i], next, map->size, entries, strings,
+                         &strings_used);
+    }
+    for (size_t i = map->rehash_index; i < map->old_size; i++) {
+        ht_snapshot_fill(map->old_buckets[i], next, map->size, entries,
+                         strings, &strings_used);
+    }
+
+    bool result =
+        ht_snapshot_write_file(path, header, buckets, entries, strings);
+    free(strings);
+    return result;
+}
+
+/*
+ * Zápis snímku tabulky do souboru.
+ *
+ * Snímek má stejný počet seznamů synonym jako tabulka a zahrnuje i položky,
+ * které se dosud nepřesunuly z původního pole. Vrací false, pokud tabulka
+ * používá rozptylovací funkci mimo HT_HASH_FUNCTIONS (snímek by po otevření
+ * nešlo prohledat), při chybě alokace nebo zápisu.
+ */
+bool ht_snapshot_write(ht_map_t *map, const char *path) {
+    // Checks if pointers to map and path are valid
+    if (map == NULL || path == NULL || map->buckets == NULL) {
+        return false;
+    }
+
+    ht_hash_id_t hash_id = ht_hash_id_of(map->hasher.function);
+    if (hash_id == HT_HASH_COUNT) {
+        return false;
+    }
+
+    ht_snapshot_header_t header = {.magic = HT_SNAPSHOT_MAGIC,
+                                   .version = HT_SNAPSHOT_VERSION,
+                                   .hash_id = (uint32_t)hash_id,
+                                   .seed = map->hasher.seed,
+                                   .bucket_count = map->size,
+                                   .item_count = map->count,
+                                   .strings_size = 0};
+
+    uint64_t *buckets = calloc(map->size + 1, sizeof(uint64_t));
+    uint64_t *next = malloc(map->size * sizeof(uint64_t));
+    ht_snapshot_entry_t *entries =
+        malloc((map->count > 0 ? map->count : 1) * sizeof(ht_snapshot_entry_t));
+
+    bool result = false;
+    if (buckets != NULL && next != NULL && entries != NULL) {
+        result = ht_snapshot_build(map, path, &header, buckets, next, entries);
+    }
+
+    free(buckets);
+    free(next);
+    free(entries);
+    return result;
+}
+
+// Checks the header and sets the pointers to the parts of the snapshot
+static bool ht_snapshot_layout(ht_snapshot_t *snapshot) {
+    const ht_snapshot_header_t *header = snapshot->header;
+    if (header->magic != HT_SNAPSHOT_MAGIC ||
+        header->version != HT_SNAPSHOT_VERSION ||
+        header->hash_id >= HT_HASH_COUNT || header->bucket_count == 0 ||
+        (header->bucket_count & (header->bucket_count - 1)) != 0) {
+        return false;
+    }
+
+    // Compares the expected size piece by piece so that nothing overflows
+    size_t rest = snapshot->size - sizeof(ht_snapshot_header_t);
+    if (header->bucket_count >= rest / sizeof(uint64_t)) {
+        return false;
+    }
+    rest -= (header->bucket_count + 1) * sizeof(uint64_t);
+    if (header->item_count > rest / sizeof(ht_snapshot_entry_t)) {
+        return false;
+    }
+    rest -= header->item_count * sizeof(ht_snapshot_entry_t);
+    if (header->strings_size != rest) {
+        return false;
+    }
+
+    const char *bytes = snapshot->data;
+    snapshot->buckets =
+        (const uint64_t *)(bytes + sizeof(ht_snapshot_header_t));
+    snapshot->entries = (const ht_snapshot_entry_t *)(snapshot->buckets +
+                                                      header->bucket_count + 1);
+    snapshot->strings = (const char *)(snapshot->entries + header->item_count);
+    return true;
+}
+
+/*
+ * Otevření snímku ze souboru.
+ *
+ * Soubor se namapuje pouze pro čtení, položky se nikam nekopírují ani
+ * neprocházejí, kontroluje se jen hlavička a velikost souboru. Meze
+ * jednotlivých seznamů a klíčů se ověřují až při vyhledávání. Vrací false,
+ * pokud soubor nejde otevřít nebo neobsahuje platný snímek.
+ */
+bool ht_snapshot_open(ht_snapshot_t *snapshot, const char *path) {
+    // Checks if pointers to snapshot and path are valid
+    if (snapshot == NULL || path == NULL) {
+        return false;
+    }
+    snapshot->data = NULL;
+    snapshot->size = 0;
+
+    int file = open(path, O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0 ||
+        (size_t)info.st_size < sizeof(ht_snapshot_header_t)) {
+        close(file);
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    void *data =
+        mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    snapshot->data = data;
+    snapshot->size = (size_t)info.st_size;
+    snapshot->header = data;
+    if (!ht_snapshot_layout(snapshot)) {
+        ht_snapshot_close(snapshot);
+        return false;
+    }
+
+    snapshot->hasher.function = ht_hash_by_id(snapshot->header->hash_id);
+    snapshot->hasher.seed = snapshot->header->seed;
+    return true;
+}
+
+/*
+ * Získání hodnoty ze snímku.
+ *
+ * Stejně jako ht_map_get vrací ukazatel na hodnotu prvku nebo NULL; hodnota
+ * leží v namapovaném souboru a nelze ji měnit.
+ */
+const float *ht_snapshot_get(const ht_snapshot_t *snapshot, const char *key) {
+    // Checks if pointers to snapshot and key are valid
+    if (snapshot == NULL || key == NULL || snapshot->data == NULL) {
+        return NULL;
+    }
+
+    size_t length;
+    uint64_t hash = ht_hasher_hash(&snapshot->hasher, key, &length);
+    size_t index = ht_snapshot_index(hash, snapshot->header->bucket_count);
+
+    // Ignores the bucket if its range lies outside of the entries
+    uint64_t first = snapshot->buckets[index];
+    uint64_t last = snapshot->buckets[index + 1];
+    if (first > last || last > snapshot->header->item_count) {
+        return NULL;
+    }
+
+    // Walks the contiguous entries of the bucket
+    uint64_t strings_size = snapshot->header->strings_size;
+    for (uint64_t i = first; i < last; i++) {
+        const ht_snapshot_entry_t *entry = &snapshot->entries[i];
+        if (entry->hash == hash && entry->length == length &&
+            length <= strings_size &&
+            entry->key_offset <= strings_size - length &&
+            memcmp(snapshot->strings + entry->key_offset, key, length) == 0) {
+            return &entry->value;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Zavření snímku a zrušení mapování souboru.
+ */
+void ht_snapshot_close(ht_snapshot_t *snapshot) {
+    if (snapshot == NULL || snapshot->data == NULL) {
+        return;
+    }
+
+    munmap(snapshot->data, snapshot->size);
+    snapshot->data = NULL;
+    snapshot->size = 0;
+}
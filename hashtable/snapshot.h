@@ -0,0 +1,61 @@
+/*
+ * Hlavičkový soubor pro snímek tabulky v souboru.
+ *
+ * Snímek obsahuje hlavičku, pole začátků seznamů synonym, položky seřazené
+ * podle seznamů a na konci řetězce klíčů. Soubor se při otevření namapuje
+ * do paměti pouze pro čtení a vyhledává se přímo v něm, bez načítání a bez
+ * znovuvytváření tabulky. Čísla se ukládají v pořadí bajtů počítače, který
+ * snímek vytvořil.
+ */
+
+#ifndef IAL_HASHTABLE_SNAPSHOT_H
+#define IAL_HASHTABLE_SNAPSHOT_H
+
+#include "hash.h"
+#include "map.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Identifikace souboru se snímkem ("IALHTSNP")
+#define HT_SNAPSHOT_MAGIC 0x504E535448414C49ULL
+
+// Verze formátu snímku
+#define HT_SNAPSHOT_VERSION 1
+
+// Hlavička snímku
+typedef struct ht_snapshot_header {
+  uint64_t magic;        // HT_SNAPSHOT_MAGIC
+  uint32_t version;      // HT_SNAPSHOT_VERSION
+  uint32_t hash_id;      // identifikátor rozptylovací funkce
+  uint64_t seed;         // semínko rozptylovací funkce
+  uint64_t bucket_count; // počet seznamů synonym (mocnina dvou)
+  uint64_t item_count;   // počet položek
+  uint64_t strings_size; // velikost řetězců klíčů v bajtech
+} ht_snapshot_header_t;
+
+// Položka snímku
+typedef struct ht_snapshot_entry {
+  uint64_t hash;       // úplný hash klíče
+  uint64_t key_offset; // začátek klíče v řetězcích klíčů
+  uint32_t length;     // délka klíče
+  float value;         // hodnota položky
+} ht_snapshot_entry_t;
+
+// Otevřený snímek
+typedef struct ht_snapshot {
+  void *data;                         // namapovaný soubor
+  size_t size;                        // velikost souboru
+  const ht_snapshot_header_t *header; // hlavička
+  const uint64_t *buckets;            // začátky seznamů, bucket_count + 1
+  const ht_snapshot_entry_t *entries; // položky seřazené podle seznamů
+  const char *strings;                // řetězce klíčů ukončené nulou
+  ht_hasher_t hasher;                 // rozptylovací funkce a semínko
+} ht_snapshot_t;
+
+bool ht_snapshot_write(ht_map_t *map, const char *path);
+bool ht_snapshot_open(ht_snapshot_t *snapshot, const char *path);
+const float *ht_snapshot_get(const ht_snapshot_t *snapshot, const char *key);
+void ht_snapshot_close(ht_snapshot_t *snapshot);
+
+#endif
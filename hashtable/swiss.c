@@ -0,0 +1,328 @@
+/*
+ * Tabulka s rozptýlenými položkami s otevřeným adresováním
+ *
+ * Horních 7 bitů otisku klíče se ukládá do řídicího bajtu slotu, zbytek
+ * otisku vybírá počáteční skupinu slotů. Vyhledávání porovná řídicí bajty
+ * celé skupiny najednou a klíče porovnává jen u slotů se shodným otiskem.
+ * Skupiny se prochází kvadraticky (posun o 1, 2, 3, ... skupin), dokud se
+ * nenarazí na skupinu s volným slotem.
+ */
+
+#include "swiss.h"
+#include "hash.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Returns the 7 bit fingerprint stored in the control byte
+static uint8_t ht_swiss_h2(uint64_t hash) {
+    return (uint8_t)(hash >> 57);
+}
+
+// Returns the first group of the probe sequence
+static size_t ht_swiss_h1(uint64_t hash) {
+    return (size_t)(hash & 0x01FFFFFFFFFFFFFFULL);
+}
+
+// Returns a bitmask of the slots of the group whose control byte is value
+static uint32_t ht_swiss_match(const uint8_t *group, uint8_t value) {
+#ifdef __SSE2__
+    __m128i control = _mm_loadu_si128((const __m128i *)group);
+    __m128i match = _mm_cmpeq_epi8(control, _mm_set1_epi8((char)value));
+    return (uint32_t)_mm_movemask_epi8(match);
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < HT_SWISS_GROUP; i++) {
+        if (group[i] == value) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+// Returns a bitmask of the empty or deleted slots of the group
+static uint32_t ht_swiss_match_free(const uint8_t *group) {
+#ifdef __SSE2__
+    __m128i control = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(control);
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < HT_SWISS_GROUP; i++) {
+        if (group[i] & 0x80) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+// Returns the index of the lowest set bit of a non-zero mask
+static int ht_swiss_lowest(uint32_t mask) {
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int index = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+// Returns the index of the slot with the key, or size if there is none
+static size_t ht_swiss_find(ht_swiss_t *table, char *key, uint64_t hash) {
+    size_t groups = table->size / HT_SWISS_GROUP;
+    size_t group = ht_swiss_h1(hash) & (groups - 1);
+    uint8_t h2 = ht_swiss_h2(hash);
+
+    for (size_t step = 1; step <= groups; step++) {
+        const uint8_t *control = &table->control[group * HT_SWISS_GROUP];
+
+        // Compares the keys of the slots with a matching fingerprint
+        uint32_t match = ht_swiss_match(control, h2);
+        while (match != 0) {
+            size_t index = group * HT_SWISS_GROUP + ht_swiss_lowest(match);
+            ht_swiss_slot_t *slot = &table->slots[index];
+            if (slot->hash == hash && strcmp(slot->key, key) == 0) {
+                return index;
+            }
+            match &= match - 1;
+        }
+
+        // An empty slot ends every probe sequence going through this group
+        if (ht_swiss_match(control, HT_SWISS_EMPTY) != 0) {
+            break;
+        }
+        group = (group + step) & (groups - 1);
+    }
+    return table->size;
+}
+
+// Returns the index of the first empty or deleted slot for the hash
+static size_t ht_swiss_find_free(ht_swiss_t *table, uint64_t hash) {
+    size_t groups = table->size / HT_SWISS_GROUP;
+    size_t group = ht_swiss_h1(hash) & (groups - 1);
+
+    for (size_t step = 1; step <= groups; step++) {
+        const uint8_t *control = &table->control[group * HT_SWISS_GROUP];
+        uint32_t mask = ht_swiss_match_free(control);
+        if (mask != 0) {
+            return group * HT_SWISS_GROUP + ht_swiss_lowest(mask);
+        }
+        group = (group + step) & (groups - 1);
+    }
+    return table->size;
+}
+
+// Allocates empty arrays for the given number of slots
+static bool ht_swiss_alloc(ht_swiss_t *table, size_t size) {
+    uint8_t *control = malloc(size);
+    ht_swiss_slot_t *slots = malloc(size * sizeof(ht_swiss_slot_t));
+    if (control == NULL || slots == NULL) {
+        free(control);
+        free(slots);
+        return false;
+    }
+
+    memset(control, HT_SWISS_EMPTY, size);
+    table->control = control;
+    table->slots = slots;
+    table->size = size;
+    table->count = 0;
+    table->deleted = 0;
+    return true;
+}
+
+/*
+ * Přestavění tabulky na zadaný počet slotů.
+ *
+ * Obsazené sloty se vloží do nových polí podle uloženého otisku, smazané
+ * sloty se tím odstraní. Při neúspěšné alokaci zůstává tabulka beze změny.
+ */
+static bool ht_swiss_rehash(ht_swiss_t *table, size_t size) {
+    ht_swiss_t old = *table;
+    if (!ht_swiss_alloc(table, size)) {
+        *table = old;
+        return false;
+    }
+
+    for (size_t i = 0; i < old.size; i++) {
+        if ((old.control[i] & 0x80) == 0) {
+            size_t index = ht_swiss_find_free(table, old.slots[i].hash);
+            table->control[index] = old.control[i];
+            table->slots[index] = old.slots[i];
+            table->count++;
+        }
+    }
+
+    free(old.control);
+    free(old.slots);
+    return true;
+}
+
+/*
+ * Inicializace tabulky — zavolá se před prvním použitím tabulky.
+ *
+ * Tabulka si uloží aktuální rozptylovací funkci s nulovým semínkem, jiné
+ * semínko lze nastavit do hasher.seed před prvním vložením. Vrací false,
+ * pokud se nepodařilo alokovat pole slotů.
+ */
+bool ht_swiss_init(ht_swiss_t *table) {
+    // Checks if pointer to table is valid
+    if (table == NULL) {
+        return false;
+    }
+
+    table->control = NULL;
+    table->slots = NULL;
+    table->size = 0;
+    table->count = 0;
+    table->deleted = 0;
+    table->hasher = ht_hasher_default();
+    return ht_swiss_alloc(table, HT_SWISS_INITIAL_SIZE);
+}
+
+/*
+ * Vyhledání prvku v tabulce.
+ *
+ * V případě úspěchu vrací ukazatel na slot nalezeného prvku; v opačném
+ * případě vrací hodnotu NULL. Ukazatel je platný do další změny tabulky.
+ */
+ht_swiss_slot_t *ht_swiss_search(ht_swiss_t *table, char *key) {
+    // Checks if pointers to table and key are valid
+    if (table == NULL || key == NULL || table->control == NULL) {
+        return NULL;
+    }
+
+    size_t index = ht_swiss_find(table, key, ht_hasher_hash(&table->hasher, key, NULL));
+    if (index == table->size) {
+        return NULL;
+    }
+    return &table->slots[index];
+}
+
+/*
+ * Vložení nového prvku do tabulky.
+ *
+ * Pokud prvek s daným klíčem už v tabulce existuje, nahradí se jeho hodnota.
+ * Tabulka se zvětší, pokud by obsazené a smazané sloty přesáhly 7/8 jejích
+ * slotů.
+ */
+void ht_swiss_insert(ht_swiss_t *table, char *key, float value) {
+    // Checks if pointers to table and key are valid
+    if (table == NULL || key == NULL || table->control == NULL) {
+        return;
+    }
+
+    // Checks if the key exists, if so, updates its value
+    uint64_t hash = ht_hasher_hash(&table->hasher, key, NULL);
+    size_t index = ht_swiss_find(table, key, hash);
+    if (index != table->size) {
+        table->slots[index].value = value;
+        return;
+    }
+
+    // Grows the table, or only drops the deleted slots if they take the space
+    if ((table->count + table->deleted + 1) * 8 > table->size * 7) {
+        size_t size = table->size;
+        if ((table->count + 1) * 16 > table->size * 7) {
+            size *= 2;
+        }
+        if (!ht_swiss_rehash(table, size)) {
+            return;
+        }
+    }
+
+    // Stores the item into the first free slot of its probe sequence
+    index = ht_swiss_find_free(table, hash);
+    if (table->control[index] == HT_SWISS_DELETED) {
+        table->deleted--;
+    }
+    table->control[index] = ht_swiss_h2(hash);
+    table->slots[index].key = key;
+    table->slots[index].hash = hash;
+    table->slots[index].value = value;
+    table->count++;
+}
+
+/*
+ * Získání hodnoty z tabulky.
+ *
+ * V případě úspěchu vrací funkce ukazatel na hodnotu prvku, v opačném
+ * případě hodnotu NULL.
+ */
+float *ht_swiss_get(ht_swiss_t *table, char *key) {
+    ht_swiss_slot_t *slot = ht_swiss_search(table, key);
+    if (slot != NULL) {
+        return &(slot->value);
+    }
+    return NULL;
+}
+
+/*
+ * Smazání prvku z tabulky.
+ *
+ * Pokud skupina slotu obsahuje volný slot, žádné vyhledávání přes ni
+ * nepokračuje a slot se může uvolnit; jinak se označí jako smazaný.
+ * Pokud prvek neexistuje, funkce nedělá nic.
+ */
+void ht_swiss_delete(ht_swiss_t *table, char *key) {
+    // Checks if pointers to table and key are valid
+    if (table == NULL || key == NULL || table->control == NULL) {
+        return;
+    }
+
+    size_t index = ht_swiss_find(table, key, ht_hasher_hash(&table->hasher, key, NULL));
+    if (index == table->size) {
+        return;
+    }
+
+    const uint8_t *group = &table->control[index - index % HT_SWISS_GROUP];
+    if (ht_swiss_match(group, HT_SWISS_EMPTY) != 0) {
+        table->control[index] = HT_SWISS_EMPTY;
+    } else {
+        table->control[index] = HT_SWISS_DELETED;
+        table->deleted++;
+    }
+    table->count--;
+}
+
+/*
+ * Smazání všech prvků z tabulky.
+ *
+ * Stačí označit všechny sloty jako volné, počet slotů zůstává zachován.
+ */
+void ht_swiss_delete_all(ht_swiss_t *table) {
+    // Checks if pointer to table is valid
+    if (table == NULL || table->control == NULL) {
+        return;
+    }
+
+    memset(table->control, HT_SWISS_EMPTY, table->size);
+    table->count = 0;
+    table->deleted = 0;
+}
+
+/*
+ * Zrušení tabulky včetně pole slotů.
+ *
+ * Před dalším použitím je nutné tabulku znovu inicializovat.
+ */
+void ht_swiss_dispose(ht_swiss_t *table) {
+    if (table == NULL) {
+        return;
+    }
+
+    free(table->control);
+    free(table->slots);
+    table->control = NULL;
+    table->slots = NULL;
+    table->size = 0;
+    table->count = 0;
+    table->deleted = 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * Hlavičkový soubor pro tabulku s otevřeným adresováním (Swiss table).
+ *
+ * Položky jsou uložené přímo v poli slotů. Ke každému slotu patří jeden
+ * řídicí bajt se stavem slotu a se sedmi bity otisku klíče; řídicí bajty
+ * se porovnávají po skupinách HT_SWISS_GROUP slotů najednou (SSE2).
+ */
+
+#ifndef IAL_HASHTABLE_SWISS_H
+#define IAL_HASHTABLE_SWISS_H
+
+#include "hash.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Počet slotů v jedné skupině
+#define HT_SWISS_GROUP 16
+
+// Počáteční počet slotů (mocnina dvou, alespoň HT_SWISS_GROUP)
+#define HT_SWISS_INITIAL_SIZE 16
+
+// Řídicí bajty volného a smazaného slotu, obsazený slot má horní bit nulový
+#define HT_SWISS_EMPTY 0x80
+#define HT_SWISS_DELETED 0xFE
+
+// Slot tabulky
+typedef struct ht_swiss_slot {
+  char *key;     // klíč prvku
+  uint64_t hash; // otisk klíče
+  float value;   // hodnota prvku
+} ht_swiss_slot_t;
+
+// Tabulka s otevřeným adresováním
+typedef struct ht_swiss {
+  uint8_t *control;        // řídicí bajty slotů
+  ht_swiss_slot_t *slots;  // pole slotů
+  size_t size;             // počet slotů (mocnina dvou)
+  size_t count;            // počet obsazených slotů
+  size_t deleted;          // počet smazaných slotů
+  ht_hasher_t hasher;      // rozptylovací funkce a semínko tabulky
+} ht_swiss_t;
+
+bool ht_swiss_init(ht_swiss_t *table);
+ht_swiss_slot_t *ht_swiss_search(ht_swiss_t *table, char *key);
+void ht_swiss_insert(ht_swiss_t *table, char *key, float value);
+float *ht_swiss_get(ht_swiss_t *table, char *key);
+void ht_swiss_delete(ht_swiss_t *table, char *key);
+void ht_swiss_delete_all(ht_swiss_t *table);
+void ht_swiss_dispose(ht_swiss_t *table);
+
+#endif
@@ -1,7 +1,9 @@
+#include "hash.h"
 #include "hashtable.h"
 #include "test_util.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define INSERT_TEST_DATA(TABLE)                                                \
   ht_insert_many(TABLE, TEST_DATA, sizeof(TEST_DATA) / sizeof(TEST_DATA[0]));
@@ -13,10 +15,32 @@ const ht_item_t TEST_DATA[15] = {
     {"USD Coin", 0.86},    {"Uniswap", 21.68},    {"Terra", 30.67},
     {"Litecoin", 156.87},  {"Avalanche", 47.03},  {"Chainlink", 21.90}};
 
+#define INSERT_MAP_TEST_DATA(MAP)                                              \
+  for (int i = 0; i < sizeof(TEST_DATA) / sizeof(TEST_DATA[0]); i++) {         \
+    ht_map_insert(MAP, TEST_DATA[i].key, TEST_DATA[i].value);                  \
+  }
+
+const ht_item_t MAP_EXTRA_DATA[10] = {
+    {"Stellar", 0.39},   {"VeChain", 0.13},  {"Filecoin", 69.83},
+    {"TRON", 0.10},      {"Monero", 261.51}, {"EOS", 4.92},
+    {"Aave", 348.66},    {"Tezos", 6.25},    {"Cosmos", 38.19},
+    {"Algorand", 1.87}};
+
+#define INSERT_SWISS_TEST_DATA(TABLE)                                          \
+  for (int i = 0; i < sizeof(TEST_DATA) / sizeof(TEST_DATA[0]); i++) {         \
+    ht_swiss_insert(TABLE, TEST_DATA[i].key, TEST_DATA[i].value);              \
+  }
+
+#define INSERT_CONCURRENT_TEST_DATA(TABLE)                                     \
+  for (int i = 0; i < sizeof(TEST_DATA) / sizeof(TEST_DATA[0]); i++) {         \
+    ht_concurrent_insert(TABLE, TEST_DATA[i].key, TEST_DATA[i].value);         \
+  }
+
 void init_test() {
   printf("Hash Table - testing script\n");
   printf("---------------------------\n");
   HT_SIZE = 13;
+  ht_hash_function = ht_hash_sum;
   printf("\nSetting HT_SIZE to prime number (%i)\n", HT_SIZE);
   printf("\n");
 }
@@ -76,6 +100,156 @@ INSERT_TEST_DATA(test_table)
 ht_delete_all(test_table);
 ENDTEST
 
+TEST_CONCURRENT(test_concurrent_insert_many,
+                "Insert many new items into a table for more threads")
+INSERT_CONCURRENT_TEST_DATA(&test_concurrent)
+ht_concurrent_insert(&test_concurrent, "Ethereum", 12.34);
+ht_concurrent_print_value(&test_concurrent, "Ethereum");
+ht_concurrent_print_value(&test_concurrent, "Missing");
+ENDTEST_CONCURRENT
+
+TEST_CONCURRENT(test_concurrent_delete,
+                "Delete items from a table for more threads")
+INSERT_CONCURRENT_TEST_DATA(&test_concurrent)
+ht_concurrent_delete(&test_concurrent, "Terra");
+ht_concurrent_delete(&test_concurrent, "Missing");
+ht_concurrent_print_value(&test_concurrent, "Terra");
+ht_concurrent_delete_all(&test_concurrent);
+ht_concurrent_insert(&test_concurrent, "Bitcoin", 53247.71);
+ENDTEST_CONCURRENT
+
+TEST(test_delete_missing, "Delete a non-existing item")
+ht_init(test_table);
+INSERT_TEST_DATA(test_table)
+ht_delete(test_table, "Missing");
+ENDTEST
+
+TEST(test_delete_chain_head, "Delete the first item of a chain")
+ht_init(test_table);
+INSERT_TEST_DATA(test_table)
+ht_delete(test_table, "Chainlink");
+ENDTEST
+
+TEST(test_insert_many_mix64, "Insert many new items using the mix64 hash")
+ht_hash_function = ht_hash_mix64;
+ht_init(test_table);
+INSERT_TEST_DATA(test_table)
+ENDTEST
+
+TEST_MAP(test_map_insert_many, "Insert many new items into a resizable table")
+INSERT_MAP_TEST_DATA(&test_map)
+ENDTEST_MAP
+
+TEST_MAP(test_map_grow, "Grow the resizable table while inserting")
+INSERT_MAP_TEST_DATA(&test_map)
+for (int i = 0; i < 10; i++) {
+  ht_map_insert(&test_map, MAP_EXTRA_DATA[i].key, MAP_EXTRA_DATA[i].value);
+}
+ht_print_item_value(ht_map_get(&test_map, "Terra"));
+ht_print_item_value(ht_map_get(&test_map, "Algorand"));
+ENDTEST_MAP
+
+TEST_MAP(test_map_rehash, "Search while the items are being moved")
+INSERT_MAP_TEST_DATA(&test_map)
+ht_map_insert(&test_map, MAP_EXTRA_DATA[0].key, MAP_EXTRA_DATA[0].value);
+ht_map_insert(&test_map, MAP_EXTRA_DATA[1].key, MAP_EXTRA_DATA[1].value);
+ht_print_item_value(ht_map_get(&test_map, "Litecoin"));
+ENDTEST_MAP
+
+TEST_MAP(test_map_delete, "Delete items from a resizable table")
+INSERT_MAP_TEST_DATA(&test_map)
+ht_map_delete(&test_map, "Terra");
+ht_map_delete(&test_map, "Bitcoin");
+ht_map_delete(&test_map, "Missing");
+ht_print_item_value(ht_map_get(&test_map, "Terra"));
+ENDTEST_MAP
+
+TEST_MAP(test_map_owned_keys, "Insert copies of the keys into an owning table")
+ht_map_dispose(&test_map);
+ht_map_init_owned(&test_map);
+char key[64];
+strcpy(key, "Bitcoin");
+ht_map_insert(&test_map, key, 53247.71);
+strcpy(key, "Wrapped Bitcoin on Ethereum");
+ht_map_insert(&test_map, key, 53180.02);
+strcpy(key, "Overwritten");
+ht_print_item_value(ht_map_get(&test_map, "Bitcoin"));
+ht_print_item_value(ht_map_get(&test_map, "Wrapped Bitcoin on Ethereum"));
+ht_map_delete(&test_map, "Bitcoin");
+ENDTEST_MAP
+
+TEST_MAP(test_map_config, "Insert into a table with its own size and hash")
+ht_map_dispose(&test_map);
+ht_map_config_t config = {.size = 5, .seed = 7, .hash_function = ht_hash_sum};
+ht_map_init_config(&test_map, &config);
+INSERT_MAP_TEST_DATA(&test_map)
+ht_hash_function = ht_hash_fnv1a;
+ht_print_item_value(ht_map_get(&test_map, "Terra"));
+ht_print_item_value(ht_map_get(&test_map, "Missing"));
+ht_hash_function = ht_hash_mix64;
+ht_map_print_stats(&test_map);
+ENDTEST_MAP
+
+TEST_MAP(test_map_batch, "Insert and get batches of items")
+char *batch_keys[26];
+float batch_values[26];
+float *batch_results[26];
+for (int i = 0; i < 15; i++) {
+  batch_keys[i] = TEST_DATA[i].key;
+  batch_values[i] = TEST_DATA[i].value;
+}
+for (int i = 0; i < 10; i++) {
+  batch_keys[15 + i] = MAP_EXTRA_DATA[i].key;
+  batch_values[15 + i] = MAP_EXTRA_DATA[i].value;
+}
+batch_keys[25] = "Terra";
+batch_values[25] = 0.01;
+ht_map_insert_many(&test_map, batch_keys, batch_values, 26);
+batch_keys[0] = "Missing";
+ht_map_get_many(&test_map, batch_keys, 26, batch_results);
+for (int i = 0; i < 26; i++) {
+  printf("%s: ", batch_keys[i]);
+  ht_print_item_value(batch_results[i]);
+}
+ENDTEST_MAP
+
+TEST_MAP(test_map_snapshot, "Write a snapshot of the table and search it")
+INSERT_MAP_TEST_DATA(&test_map)
+ht_map_insert(&test_map, MAP_EXTRA_DATA[0].key, MAP_EXTRA_DATA[0].value);
+ht_map_insert(&test_map, MAP_EXTRA_DATA[1].key, MAP_EXTRA_DATA[1].value);
+ht_snapshot_t snapshot;
+printf("Write: %d\n", ht_snapshot_write(&test_map, "test_snapshot.ht"));
+printf("Open: %d\n", ht_snapshot_open(&snapshot, "test_snapshot.ht"));
+ht_snapshot_print_value(&snapshot, "Terra");
+ht_snapshot_print_value(&snapshot, "Stellar");
+ht_snapshot_print_value(&snapshot, "Litecoin");
+ht_snapshot_print_value(&snapshot, "Missing");
+ht_snapshot_close(&snapshot);
+remove("test_snapshot.ht");
+printf("Open invalid: %d\n", ht_snapshot_open(&snapshot, "reference.out"));
+ENDTEST_MAP
+
+TEST_SWISS(test_swiss_insert_many, "Insert many new items into a swiss table")
+INSERT_SWISS_TEST_DATA(&test_swiss)
+ht_swiss_insert(&test_swiss, "Ethereum", 12.34);
+ht_print_item_value(ht_swiss_get(&test_swiss, "Ethereum"));
+ht_print_item_value(ht_swiss_get(&test_swiss, "Missing"));
+ENDTEST_SWISS
+
+TEST_SWISS(test_swiss_delete, "Delete items from a swiss table")
+INSERT_SWISS_TEST_DATA(&test_swiss)
+ht_swiss_delete(&test_swiss, "Terra");
+ht_swiss_delete(&test_swiss, "Bitcoin");
+ht_swiss_delete(&test_swiss, "Missing");
+ht_print_item_value(ht_swiss_get(&test_swiss, "Terra"));
+ht_print_item_value(ht_swiss_get(&test_swiss, "Cardano"));
+ENDTEST_SWISS
+
+TEST_SWISS(test_swiss_delete_all, "Delete all the items from a swiss table")
+INSERT_SWISS_TEST_DATA(&test_swiss)
+ht_swiss_delete_all(&test_swiss);
+ENDTEST_SWISS
+
 int main(int argc, char *argv[]) {
   init_uninitialized_item();
   init_test();
@@ -90,6 +264,23 @@ int main(int argc, char *argv[]) {
   test_get();
   test_delete();
   test_delete_all();
+  test_delete_missing();
+  test_delete_chain_head();
+  test_insert_many_mix64();
+  test_map_insert_many();
+  test_map_grow();
+  test_map_rehash();
+  test_map_delete();
+  test_map_owned_keys();
+  test_map_config();
+  test_map_batch();
+  test_map_snapshot();
+  test_swiss_insert_many();
+  test_swiss_delete();
+  test_swiss_delete_all();
+  test_concurrent_insert_many();
+  test_concurrent_delete();
+  ht_hash_function = ht_hash_sum;
 
   free(uninitialized_item);
 }
@@ -50,6 +50,109 @@ void ht_print_table(ht_table_t *table) {
   printf("------------------------------------\n");
 }
 
+void ht_map_print_chain(ht_item_t *item, int *max_count) {
+  int count = 0;
+  while (item != NULL) {
+    printf("(%s,%.2f)", item->key, item->value);
+    count++;
+    item = item->next;
+  }
+  printf("\n");
+  if (count > *max_count) {
+    *max_count = count;
+  }
+}
+
+void ht_map_print(ht_map_t *map) {
+  int max_count = 0;
+
+  printf("------------HASH MAP----------------\n");
+  printf("Size: %zu\n", map->size);
+  for (size_t i = 0; i < map->size; i++) {
+    printf("%zu: ", i);
+    ht_map_print_chain(map->buckets[i], &max_count);
+  }
+  if (map->old_buckets != NULL) {
+    printf("Rehashing from size %zu, %zu chains moved\n", map->old_size,
+           map->rehash_index);
+    for (size_t i = map->rehash_index; i < map->old_size; i++) {
+      printf("old %zu: ", i);
+      ht_map_print_chain(map->old_buckets[i], &max_count);
+    }
+  }
+
+  printf("------------------------------------\n");
+  printf("Total items in hash map: %zu\n", map->count);
+  printf("Maximum hash collisions: %i\n", max_count == 0 ? 0 : max_count - 1);
+  printf("------------------------------------\n");
+}
+
+void ht_map_print_stats(ht_map_t *map) {
+  ht_map_stats_t stats = ht_map_get_stats(map);
+
+  printf("Hash function: %s, seed: %llu\n",
+         ht_hash_name(ht_hash_id_of(map->hasher.function)),
+         (unsigned long long)map->hasher.seed);
+  printf("Lookups: %zu, probes: %zu, resizes: %zu\n", stats.lookups,
+         stats.probes, stats.resizes);
+}
+
+void ht_swiss_print(ht_swiss_t *table) {
+  printf("------------SWISS TABLE-------------\n");
+  printf("Size: %zu\n", table->size);
+  for (size_t i = 0; i < table->size; i++) {
+    printf("%zu: ", i);
+    if (table->control[i] == HT_SWISS_DELETED) {
+      printf("*DELETED*");
+    } else if (table->control[i] != HT_SWISS_EMPTY) {
+      printf("(%s,%.2f)", table->slots[i].key, table->slots[i].value);
+    }
+    printf("\n");
+  }
+
+  printf("------------------------------------\n");
+  printf("Total items in swiss table: %zu\n", table->count);
+  printf("Deleted slots: %zu\n", table->deleted);
+  printf("------------------------------------\n");
+}
+
+void ht_concurrent_print(ht_concurrent_t *table) {
+  printf("---------CONCURRENT HASH TABLE------\n");
+  printf("Size: %zu\n", table->size);
+  for (size_t i = 0; i < table->size; i++) {
+    printf("%zu: ", i);
+    ht_concurrent_item_t *item = atomic_load(&table->buckets[i]);
+    while (item != NULL) {
+      printf("(%s,%.2f)", item->key, atomic_load(&item->value));
+      item = atomic_load(&item->next);
+    }
+    printf("\n");
+  }
+
+  printf("------------------------------------\n");
+  printf("Total items in hash table: %zu\n", atomic_load(&table->count));
+  printf("------------------------------------\n");
+}
+
+void ht_concurrent_print_value(ht_concurrent_t *table, char *key) {
+  float value;
+  if (ht_concurrent_get(table, key, &value)) {
+    ht_print_item_value(&value);
+  } else {
+    ht_print_item_value(NULL);
+  }
+}
+
+void ht_snapshot_print_value(ht_snapshot_t *snapshot, char *key) {
+  const float *value = ht_snapshot_get(snapshot, key);
+  if (value != NULL) {
+    float copy = *value;
+    ht_print_item_value(&copy);
+  } else {
+    ht_print_item_value(NULL);
+  }
+}
+
 void init_uninitialized_item() {
   uninitialized_item = (ht_item_t *)malloc(sizeof(ht_item_t));
   uninitialized_item->key = "*UNINITIALIZED*";
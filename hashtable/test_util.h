@@ -1,7 +1,11 @@
 #ifndef IAL_HASHTABLE_TEST_UTIL_H
 #define IAL_HASHTABLE_TEST_UTIL_H
 
+#include "concurrent.h"
 #include "hashtable.h"
+#include "map.h"
+#include "snapshot.h"
+#include "swiss.h"
 
 #define TEST(NAME, DESCRIPTION)                                                \
   void NAME() {                                                                \
@@ -17,11 +21,56 @@
   printf("\n");                                                                \
   }
 
+#define TEST_MAP(NAME, DESCRIPTION)                                            \
+  void NAME() {                                                                \
+    printf("[%s] %s\n", #NAME, DESCRIPTION);                                   \
+    ht_map_t test_map;                                                         \
+    ht_map_init(&test_map);
+
+#define ENDTEST_MAP                                                            \
+  printf("\n");                                                                \
+  ht_map_print(&test_map);                                                     \
+  ht_map_dispose(&test_map);                                                   \
+  printf("\n");                                                                \
+  }
+
+#define TEST_SWISS(NAME, DESCRIPTION)                                          \
+  void NAME() {                                                                \
+    printf("[%s] %s\n", #NAME, DESCRIPTION);                                   \
+    ht_swiss_t test_swiss;                                                     \
+    ht_swiss_init(&test_swiss);
+
+#define ENDTEST_SWISS                                                          \
+  printf("\n");                                                                \
+  ht_swiss_print(&test_swiss);                                                 \
+  ht_swiss_dispose(&test_swiss);                                               \
+  printf("\n");                                                                \
+  }
+
+#define TEST_CONCURRENT(NAME, DESCRIPTION)                                     \
+  void NAME() {                                                                \
+    printf("[%s] %s\n", #NAME, DESCRIPTION);                                   \
+    ht_concurrent_t test_concurrent;                                           \
+    ht_concurrent_init(&test_concurrent, 16);
+
+#define ENDTEST_CONCURRENT                                                     \
+  printf("\n");                                                                \
+  ht_concurrent_print(&test_concurrent);                                       \
+  ht_concurrent_dispose(&test_concurrent);                                     \
+  printf("\n");                                                                \
+  }
+
 extern ht_item_t *uninitialized_item;
 
 void ht_print_item_value(float *value);
 void ht_print_item(ht_item_t *item);
 void ht_print_table(ht_table_t *table);
+void ht_map_print(ht_map_t *map);
+void ht_map_print_stats(ht_map_t *map);
+void ht_swiss_print(ht_swiss_t *table);
+void ht_concurrent_print(ht_concurrent_t *table);
+void ht_concurrent_print_value(ht_concurrent_t *table, char *key);
+void ht_snapshot_print_value(ht_snapshot_t *snapshot, char *key);
 void ht_insert_many(ht_table_t *table, const ht_item_t items[], int count);
 
 void init_uninitialized_item();